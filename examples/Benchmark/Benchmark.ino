@@ -0,0 +1,281 @@
+/*
+ * Benchmark.ino
+ * Throughput benchmark for the DS2482_OneWire library
+ *
+ * Measures, at each I2C clock rate, how long a full search takes per device, how many scratchpad reads per second
+ * the bus sustains, and how many I2C transactions each 1-Wire operation costs. The transaction counts need the library
+ * to be built with ONEWIRE_ENABLE_STATS set to 1.
+ *
+ * Any DS18B20-style sensors on the bus will do. DS2408 or DS2413 switches, if there are any, are also used to measure
+ * PIO streams; only 0xFF (all outputs off) is ever written to them. DS2431 or DS28EC20 EEPROMs are read, and their
+ * first rows are programmed with the data they already hold, so that their contents are kept. The same sketch also runs on a PC against the simulator in
+ * extras/host (see scripts/run_host_benchmark.sh), where the results are fully deterministic.
+ */
+
+
+#include <DS2482_OneWire.h>
+#include <OneWirePIO.h>
+#include <OneWireEEPROM.h>
+
+// This is required for the Arduino IDE + DS2482
+#include <Wire.h>
+
+#define MAX_DEVICES		16
+#define SCRATCHPAD_READS	50
+#define PIO_SAMPLES		64
+#define EEPROM_BYTES		64
+
+// When instantiated with no parameters, uses I2C address 18
+OneWire oneWire;
+OneWirePIO pio(oneWire);
+
+uint8_t devices[MAX_DEVICES][8];
+uint8_t deviceCount = 0;
+
+// The DS2482 is specified up to 400kHz; 1MHz is out of spec, so it is only measured against the simulator
+#ifdef DS2482OW_HOST
+const uint32_t clockRates[] = { 100000, 400000, 1000000 };
+#else
+const uint32_t clockRates[] = { 100000, 400000 };
+#endif
+
+
+void startMeasurement()
+{
+#if ONEWIRE_ENABLE_STATS
+  oneWire.resetStats();
+#endif
+}
+
+void report(const char *name, uint32_t operations, uint32_t elapsed)
+{
+  if (!operations) operations = 1;
+
+  Serial.print("  ");
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(elapsed / operations);
+  Serial.print(" us/op, ");
+  Serial.print(elapsed ? (1000000UL * operations) / elapsed : 0);
+  Serial.print(" op/s");
+
+#if ONEWIRE_ENABLE_STATS
+  const OneWireStats &stats = oneWire.getStats();
+  Serial.print(", ");
+  Serial.print((float)(stats.i2cWrites + stats.i2cReads) / operations);
+  Serial.print(" I2C/op, ");
+  Serial.print((float)stats.polls / operations);
+  Serial.print(" polls/op");
+#endif
+
+  Serial.println();
+}
+
+void benchmarkSearch()
+{
+  uint8_t rom[8];
+  uint32_t start;
+
+  startMeasurement();
+  start = micros();
+
+  deviceCount = 0;
+  oneWire.reset_search();
+  while (oneWire.search(rom))
+  {
+    if (OneWire::crc8(rom, 7) == rom[7] && deviceCount < MAX_DEVICES)
+    {
+      memcpy(devices[deviceCount++], rom, 8);
+    }
+  }
+
+  report("search (per device)", deviceCount, micros() - start);
+}
+
+void benchmarkReset()
+{
+  uint32_t start;
+
+  startMeasurement();
+  start = micros();
+  for (uint8_t i = 0; i < SCRATCHPAD_READS; i++)
+  {
+    oneWire.reset();
+  }
+  report("reset", SCRATCHPAD_READS, micros() - start);
+}
+
+void benchmarkSelect()
+{
+  uint32_t start;
+
+  oneWire.reset();
+  startMeasurement();
+  start = micros();
+  for (uint8_t i = 0; i < SCRATCHPAD_READS; i++)
+  {
+    oneWire.select(devices[i % deviceCount]);
+  }
+  report("select", SCRATCHPAD_READS, micros() - start);
+}
+
+bool isSensor(const uint8_t *rom)
+{
+  return rom[0] == 0x10 || rom[0] == 0x22 || rom[0] == 0x28;
+}
+
+void benchmarkScratchpad()
+{
+  uint8_t sensors[MAX_DEVICES];
+  uint8_t sensorCount = 0;
+  uint8_t scratchpad[9];
+  uint8_t errors = 0;
+  uint32_t start;
+
+  for (uint8_t d = 0; d < deviceCount; d++)
+  {
+    if (isSensor(devices[d])) sensors[sensorCount++] = d;
+  }
+  if (!sensorCount) return;
+
+  startMeasurement();
+  start = micros();
+  for (uint8_t i = 0; i < SCRATCHPAD_READS; i++)
+  {
+    oneWire.reset();
+    oneWire.select(devices[sensors[i % sensorCount]]);
+    oneWire.write(0xBE);
+    if (oneWire.wireReadBytes(scratchpad, sizeof(scratchpad))) errors++;
+  }
+  report("scratchpad read", SCRATCHPAD_READS, micros() - start);
+
+  if (errors)
+  {
+    Serial.print("  CRC errors: ");
+    Serial.println(errors);
+  }
+}
+
+void benchmarkPIO()
+{
+  uint8_t states[PIO_SAMPLES];
+  uint8_t samples[PIO_SAMPLES];
+  uint16_t written;
+  uint16_t sampled;
+  uint32_t start;
+
+  memset(states, 0xFF, sizeof(states));
+
+  for (uint8_t d = 0; d < deviceCount; d++)
+  {
+    const char *name;
+    if (devices[d][0] == ONEWIRE_FAMILY_DS2408) name = "DS2408";
+    else if (devices[d][0] == ONEWIRE_FAMILY_DS2413) name = "DS2413";
+    else continue;
+
+    Serial.print("  ");
+    Serial.print(name);
+    Serial.println(":");
+
+    // The switch is selected before each measurement starts, so that only the stream itself is measured
+    if (!pio.beginWrite(devices[d])) continue;
+    startMeasurement();
+    start = micros();
+    written = pio.write(states, PIO_SAMPLES);
+    report("  PIO write", written, micros() - start);
+
+    if (!pio.beginRead(devices[d])) continue;
+    startMeasurement();
+    start = micros();
+    sampled = pio.read(samples, PIO_SAMPLES);
+    report("  PIO read", sampled, micros() - start);
+
+    if (written != PIO_SAMPLES || sampled != PIO_SAMPLES)
+    {
+      Serial.print("  PIO check failures: ");
+      Serial.println(2 * PIO_SAMPLES - written - sampled);
+    }
+  }
+}
+
+void benchmarkEEPROM()
+{
+  uint8_t data[EEPROM_BYTES];
+  uint8_t check[EEPROM_BYTES];
+  uint8_t result;
+  uint32_t start;
+
+  for (uint8_t d = 0; d < deviceCount; d++)
+  {
+    if (devices[d][0] != ONEWIRE_FAMILY_DS2431 && devices[d][0] != ONEWIRE_FAMILY_DS28EC20) continue;
+
+    OneWireEEPROM eeprom(oneWire, devices[d]);
+
+    Serial.print("  ");
+    Serial.print(devices[d][0] == ONEWIRE_FAMILY_DS2431 ? "DS2431" : "DS28EC20");
+    Serial.println(":");
+
+    startMeasurement();
+    start = micros();
+    result = eeprom.read(0, data, EEPROM_BYTES);
+    report("  EEPROM read (per byte)", EEPROM_BYTES, micros() - start);
+
+    // Whole rows are written back as they were read, through the scratchpad, its read-back and the copy
+    if (result == ONEWIRE_EEPROM_OK)
+    {
+      startMeasurement();
+      start = micros();
+      result = eeprom.write(0, data, EEPROM_BYTES);
+      report("  EEPROM write (per row)", EEPROM_BYTES / eeprom.getRowSize(), micros() - start);
+    }
+
+    if (result == ONEWIRE_EEPROM_OK)
+    {
+      result = eeprom.read(0, check, EEPROM_BYTES);
+      if (result == ONEWIRE_EEPROM_OK && memcmp(data, check, EEPROM_BYTES)) result = ONEWIRE_EEPROM_VERIFY;
+    }
+
+    if (result != ONEWIRE_EEPROM_OK)
+    {
+      Serial.print("  EEPROM error: ");
+      Serial.println(result);
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println("DS2482_OneWire benchmark");
+
+  oneWire.deviceReset();
+
+  for (uint8_t i = 0; i < sizeof(clockRates) / sizeof(clockRates[0]); i++)
+  {
+    Wire.setClock(clockRates[i]);
+
+    Serial.print(clockRates[i] / 1000);
+    Serial.println(" kHz:");
+
+    benchmarkSearch();
+    if (!deviceCount)
+    {
+      Serial.println("  no devices found");
+      continue;
+    }
+
+    benchmarkReset();
+    benchmarkSelect();
+    benchmarkScratchpad();
+    benchmarkPIO();
+    benchmarkEEPROM();
+  }
+
+#if !ONEWIRE_ENABLE_STATS
+  Serial.println("Build with ONEWIRE_ENABLE_STATS=1 for I2C transaction counts");
+#endif
+}
+
+void loop()
+{
+}
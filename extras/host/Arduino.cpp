@@ -0,0 +1,155 @@
+/**
+ * \file Arduino.cpp
+ * Host-side implementation of the Arduino core shim and the mock \c TwoWire bus.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+static uint32_t sNow = 0;
+
+uint32_t HostClock::now() {
+	return sNow;
+}
+
+void HostClock::advance(uint32_t us) {
+	sNow += us;
+}
+
+/* Reading the clock takes time too, so that a loop which spins on micros() alone still terminates */
+uint32_t micros() {
+	return ++sNow;
+}
+
+uint32_t millis() {
+	return sNow / 1000;
+}
+
+void delay(uint32_t ms) {
+	sNow += ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+	sNow += us;
+}
+
+void yield() {
+	/* Yielding still costs a little time, so that spin loops built on yield() terminate */
+	sNow += 1;
+}
+
+
+HostSerial Serial;
+
+size_t HostSerial::print(const char *s) {
+	return fputs(s, stdout) >= 0 ? strlen(s) : 0;
+}
+
+size_t HostSerial::print(char c) {
+	return fputc(c, stdout) == c ? 1 : 0;
+}
+
+size_t HostSerial::print(long v, int base) {
+	if (v < 0 && base == DEC) {
+		return print('-') + print((unsigned long)-v, base);
+	}
+	return print((unsigned long)v, base);
+}
+
+size_t HostSerial::print(unsigned long v, int base) {
+	return printf(base == HEX ? "%lX" : "%lu", v);
+}
+
+size_t HostSerial::print(double v, int digits) {
+	return printf("%.*f", digits, v);
+}
+
+
+TwoWire Wire;
+TwoWire Wire1;
+
+TwoWire::TwoWire() : mClock(100000), mTxAddress(0), mTxLength(0), mRxLength(0), mRxIndex(0) {
+	memset(mDevices, 0, sizeof(mDevices));
+	resetCounters();
+}
+
+void TwoWire::attach(uint8_t address, I2CPeripheral *device) {
+	mDevices[address & 0x7F] = device;
+}
+
+/*
+ * Every byte costs 9 SCL periods (8 data bits + ACK); the address byte plus START/STOP framing is counted as one more
+ * byte plus one bit period.
+ */
+void TwoWire::busTime(uint8_t bytes) {
+	uint32_t bits = (uint32_t)(bytes + 1) * 9 + 1;
+	HostClock::advance((bits * 1000000UL + mClock - 1) / mClock);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+	mTxAddress = address & 0x7F;
+	mTxLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+	if (mTxLength >= BUFFER_LENGTH) {
+		return 0;
+	}
+	mTxBuffer[mTxLength++] = data;
+	return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+	I2CPeripheral *device = mDevices[mTxAddress];
+
+	mCounters.writes++;
+	mCounters.bytes += mTxLength;
+	busTime(mTxLength);
+
+	if (!device) {
+		mCounters.nacks++;
+		return 2;
+	}
+
+	if (!device->i2cWrite(mTxBuffer, mTxLength)) {
+		mCounters.nacks++;
+		return 3;
+	}
+
+	return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t) {
+	I2CPeripheral *device = mDevices[address & 0x7F];
+
+	if (quantity > BUFFER_LENGTH) {
+		quantity = BUFFER_LENGTH;
+	}
+
+	mCounters.reads++;
+	mRxIndex = 0;
+	mRxLength = 0;
+
+	if (!device) {
+		mCounters.nacks++;
+		busTime(0);
+		return 0;
+	}
+
+	/* Each byte is clocked out individually, so the peripheral sees time move on between the bytes of one read */
+	HostClock::advance((10 * 1000000UL + mClock - 1) / mClock);
+	for (uint8_t i = 0; i < quantity; i++) {
+		mRxBuffer[mRxLength++] = device->i2cRead();
+		HostClock::advance((9 * 1000000UL + mClock - 1) / mClock);
+	}
+	mCounters.bytes += quantity;
+
+	return mRxLength;
+}
+
+int TwoWire::read() {
+	if (mRxIndex >= mRxLength) {
+		return -1;
+	}
+	return mRxBuffer[mRxIndex++];
+}
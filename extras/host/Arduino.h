@@ -0,0 +1,64 @@
+/**
+ * \file Arduino.h
+ * Minimal host-side stand-in for the Arduino core, providing just enough of the API for the DS2482_OneWire library to
+ * build and run on a PC. Time is virtual: \c delay() and \c delayMicroseconds() advance a simulated clock instead of
+ * sleeping, which keeps every benchmark run deterministic.
+ */
+
+#ifndef _DS2482OW__HOST_ARDUINO_H__
+#define _DS2482OW__HOST_ARDUINO_H__
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HEX	16
+#define DEC	10
+
+#define PROGMEM
+#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+
+typedef uint8_t byte;
+
+/**
+ * \namespace HostClock	The simulated time base shared by the Arduino shim, the mock \c Wire object and the DS2482
+ *						simulator.
+ */
+namespace HostClock {
+	/** Returns the current simulated time, in microseconds. */
+	uint32_t now();
+
+	/** Advances the simulated time by the specified number of microseconds. */
+	void advance(uint32_t us);
+}
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+/**
+ * \class HostSerial	A tiny \c Serial replacement which writes to \c stdout.
+ */
+class HostSerial {
+public:
+	void begin(uint32_t) {}
+	size_t print(const char *s);
+	size_t print(char c);
+	size_t print(long v, int base = DEC);
+	size_t print(unsigned long v, int base = DEC);
+	size_t print(int v, int base = DEC) { return print((long)v, base); }
+	size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+	size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+	size_t print(double v, int digits = 2);
+	size_t println() { return print("\n"); }
+	template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+	template <typename T> size_t println(T v, int f) { size_t n = print(v, f); return n + println(); }
+};
+
+extern HostSerial Serial;
+
+#endif	/* _DS2482OW__HOST_ARDUINO_H__ */
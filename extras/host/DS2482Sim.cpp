@@ -0,0 +1,241 @@
+/**
+ * \file DS2482Sim.cpp
+ * Register-level model of the DS2482 I²C to 1-Wire bridge.
+ */
+
+#include "DS2482Sim.h"
+
+/* 1-Wire timings, in microseconds, for standard and overdrive speed (DS2482-100 datasheet, tRSTL + tRSTH and tSLOT) */
+#define SIM_RESET_STANDARD		1148
+#define SIM_RESET_OVERDRIVE		146
+#define SIM_SLOT_STANDARD		70
+#define SIM_SLOT_OVERDRIVE		11
+
+static const uint8_t sChannelCodes[8] = { 0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87 };
+static const uint8_t sChannelReadback[8] = { 0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87 };
+
+
+DS2482Sim::DS2482Sim(uint8_t channels) :
+	mChannels(channels), mChannel(0), mStatus(0x18), mData(0), mConfig(0), mReadPointer(0xF0), mBusyUntil(0),
+	mPullupActive(false), mPullupStart(0), mPullupTotal(0) {
+	resetCounters();
+}
+
+
+uint32_t DS2482Sim::strongPullupTime() const {
+	uint32_t total = mPullupTotal;
+
+	if (mPullupActive && HostClock::now() > mPullupStart) {
+		total += HostClock::now() - mPullupStart;
+	}
+
+	return total;
+}
+
+
+bool DS2482Sim::busy() const {
+	return (int32_t)(mBusyUntil - HostClock::now()) > 0;
+}
+
+
+void DS2482Sim::startOperation(uint32_t duration) {
+	mBusyUntil = HostClock::now() + duration;
+	mReadPointer = 0xF0;
+}
+
+
+void DS2482Sim::endPullup() {
+	if (mPullupActive) {
+		mPullupTotal += strongPullupTime() - mPullupTotal;
+		mPullupActive = false;
+		mConfig &= ~0x04;
+	}
+}
+
+
+bool DS2482Sim::command(const uint8_t *data, uint8_t length, uint8_t &used) {
+	uint8_t slot = overdrive() ? SIM_SLOT_OVERDRIVE : SIM_SLOT_STANDARD;
+	SimBus &wire = mBus[mChannel];
+
+	used = 1;
+
+	switch (data[0]) {
+		case 0xF0:	/* Device Reset */
+			endPullup();
+			mBusyUntil = 0;
+			mStatus = 0x18;
+			mConfig = 0;
+			mChannel = 0;
+			mReadPointer = 0xF0;
+			return true;
+
+		case 0xE1:	/* Set Read Pointer */
+			used = 2;
+			if (length < 2 || !(data[1] == 0xF0 || data[1] == 0xE1 || data[1] == 0xC3 ||
+					(data[1] == 0xD2 && mChannels == 8))) {
+				return false;
+			}
+			mCounters.pointerWrites++;
+			mReadPointer = data[1];
+			return true;
+
+		case 0xD2:	/* Write Configuration */
+			used = 2;
+			if (length < 2 || busy() || ((data[1] >> 4) ^ 0x0F) != (data[1] & 0x0F)) {
+				return false;
+			}
+			mCounters.configWrites++;
+			if (!(data[1] & 0x04)) {
+				endPullup();
+			}
+			mConfig = data[1] & 0x0F;
+			mStatus &= ~0x10;
+			mReadPointer = 0xC3;
+			return true;
+
+		case 0xC3: {	/* Channel Select */
+			used = 2;
+			if (length < 2 || busy() || mChannels != 8) {
+				return false;
+			}
+			uint8_t channel = 0;
+			while (channel < 8 && sChannelCodes[channel] != data[1]) {
+				channel++;
+			}
+			if (channel == 8) {
+				return false;
+			}
+			mCounters.channelSelects++;
+			mChannel = channel;
+			mReadPointer = 0xD2;
+			return true;
+		}
+
+		case 0xB4: {	/* 1-Wire Reset */
+			if (busy()) {
+				return false;
+			}
+			endPullup();
+			bool presence = wire.reset(overdrive());
+			mStatus = (mStatus & 0x08) | (presence ? 0x02 : 0x00);
+			startOperation(overdrive() ? SIM_RESET_OVERDRIVE : SIM_RESET_STANDARD);
+			return true;
+		}
+
+		case 0xA5: {	/* 1-Wire Write Byte */
+			used = 2;
+			if (length < 2 || busy()) {
+				return false;
+			}
+			endPullup();
+			for (uint8_t i = 0; i < 8; i++) {
+				wire.slot((data[1] >> i) & 1, overdrive());
+			}
+			startOperation(8 * slot);
+			if (mConfig & 0x04) {
+				mPullupActive = true;
+				mPullupStart = mBusyUntil;
+			}
+			return true;
+		}
+
+		case 0x96: {	/* 1-Wire Read Byte */
+			if (busy()) {
+				return false;
+			}
+			endPullup();
+			mData = 0;
+			for (uint8_t i = 0; i < 8; i++) {
+				mData |= wire.slot(1, overdrive()) << i;
+			}
+			startOperation(8 * slot);
+			return true;
+		}
+
+		case 0x87: {	/* 1-Wire Single Bit */
+			used = 2;
+			if (length < 2 || busy()) {
+				return false;
+			}
+			endPullup();
+			uint8_t bit = wire.slot((data[1] & 0x80) ? 1 : 0, overdrive());
+			mStatus = (mStatus & ~0x20) | (bit ? 0x20 : 0x00);
+			startOperation(slot);
+			if (mConfig & 0x04) {
+				mPullupActive = true;
+				mPullupStart = mBusyUntil;
+			}
+			return true;
+		}
+
+		case 0x78: {	/* 1-Wire Triplet */
+			used = 2;
+			if (length < 2 || busy()) {
+				return false;
+			}
+			endPullup();
+			uint8_t id = wire.slot(1, overdrive());
+			uint8_t cmp = wire.slot(1, overdrive());
+			uint8_t dir;
+			if (id != cmp) {
+				dir = id;
+			} else if (id) {
+				dir = 1;
+			} else {
+				dir = (data[1] & 0x80) ? 1 : 0;
+			}
+			wire.slot(dir, overdrive());
+			mStatus = (mStatus & 0x1E) | (id ? 0x20 : 0) | (cmp ? 0x40 : 0) | (dir ? 0x80 : 0);
+			startOperation(3 * slot);
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
+
+
+bool DS2482Sim::i2cWrite(const uint8_t *data, uint8_t length) {
+	/* An empty write is an address probe, which the bridge always acknowledges */
+	while (length) {
+		uint8_t used;
+
+		if (!command(data, length, used)) {
+			mCounters.dropped++;
+			return false;
+		}
+
+		mCounters.commands++;
+		data += used;
+		length = (used > length) ? 0 : length - used;
+	}
+
+	return true;
+}
+
+
+uint8_t DS2482Sim::i2cRead() {
+	switch (mReadPointer) {
+		case 0xF0: {
+			uint8_t status = mStatus | (busy() ? 0x01 : 0x00);
+			mCounters.statusReads++;
+			if (status & 0x01) {
+				mCounters.busyReads++;
+			}
+			return status;
+		}
+
+		case 0xE1:
+			return mData;
+
+		case 0xC3:
+			return mConfig;
+
+		case 0xD2:
+			return sChannelReadback[mChannel];
+
+		default:
+			return 0xFF;
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ * \file DS2482Sim.h
+ * A register-level model of the DS2482-100 / DS2482-800 I²C to 1-Wire bridge, driven by the mock \c TwoWire bus. The
+ * model enforces the same rules as the real part: 1-Wire commands issued while the bridge is busy are not
+ * acknowledged, the read pointer moves as documented in the datasheet, and every 1-Wire operation keeps the bridge
+ * busy for its datasheet duration at the selected speed.
+ */
+
+#ifndef _DS2482OW__HOST_DS2482SIM_H__
+#define _DS2482OW__HOST_DS2482SIM_H__
+
+#include "Wire.h"
+#include "OneWireSim.h"
+
+/**
+ * \struct DS2482SimCounters	Per-bridge command accounting.
+ */
+struct DS2482SimCounters {
+	uint32_t commands;			/*!< Commands accepted by the bridge */
+	uint32_t dropped;			/*!< Commands refused (NACKed) because the bridge was busy or the command was invalid */
+	uint32_t statusReads;		/*!< Bytes read while the read pointer was on the status register */
+	uint32_t busyReads;			/*!< Status bytes read while the 1-Wire busy bit was set */
+	uint32_t configWrites;		/*!< Write Configuration commands accepted */
+	uint32_t pointerWrites;		/*!< Set Read Pointer commands accepted */
+	uint32_t channelSelects;	/*!< Channel Select commands accepted */
+};
+
+class DS2482Sim : public I2CPeripheral {
+public:
+	/**
+	 * \param[in]	channels	1 to model a DS2482-100, 8 to model a DS2482-800.
+	 */
+	DS2482Sim(uint8_t channels = 1);
+
+	/** The 1-Wire segment attached to the specified channel. */
+	SimBus &bus(uint8_t channel = 0) { return mBus[channel]; }
+
+	/** Whether a strong pullup is currently being driven onto the active channel. */
+	bool strongPullupActive() const { return mPullupActive; }
+
+	/** Total time, in microseconds, during which the strong pullup has been driven. */
+	uint32_t strongPullupTime() const;
+
+	const DS2482SimCounters &counters() const { return mCounters; }
+	void resetCounters() { memset(&mCounters, 0, sizeof(mCounters)); }
+
+	bool i2cWrite(const uint8_t *data, uint8_t length);
+	uint8_t i2cRead();
+
+private:
+	bool busy() const;
+	bool overdrive() const { return mConfig & 0x08; }
+	void startOperation(uint32_t duration);
+	void endPullup();
+	bool command(const uint8_t *data, uint8_t length, uint8_t &used);
+
+	SimBus mBus[8];
+	uint8_t mChannels;
+	uint8_t mChannel;
+
+	uint8_t mStatus;
+	uint8_t mData;
+	uint8_t mConfig;
+	uint8_t mReadPointer;
+
+	uint32_t mBusyUntil;
+	bool mPullupActive;
+	uint32_t mPullupStart;
+	uint32_t mPullupTotal;
+
+	DS2482SimCounters mCounters;
+};
+
+#endif	/* _DS2482OW__HOST_DS2482SIM_H__ */
@@ -0,0 +1,686 @@
+/**
+ * \file OneWireSim.cpp
+ * Slot-level 1-Wire bus and device models used by the host-side simulator.
+ */
+
+#include "OneWireSim.h"
+
+
+SimDevice::SimDevice(const uint8_t rom[8]) :
+	connected(true), corruptSlots(0), selections(0), supportsResume(false), supportsOverdrive(false),
+	mState(STATE_IDLE), mOverdrive(false), mMatchRevert(false), mResumeFlag(false), mBitCount(0), mShift(0), mSearchPhase(0),
+	mTxLength(0), mTxIndex(0), mTxBit(0) {
+	memcpy(mRom, rom, 8);
+}
+
+
+void SimDevice::makeRom(uint8_t rom[8], uint8_t family, uint32_t serial) {
+	rom[0] = family;
+	for (uint8_t i = 1; i < 7; i++) {
+		rom[i] = (i <= 4) ? (uint8_t)(serial >> ((i - 1) * 8)) : 0;
+	}
+	rom[7] = crc8(rom, 7);
+}
+
+
+uint8_t SimDevice::crc8(const uint8_t *data, uint8_t length) {
+	uint8_t crc = 0;
+
+	while (length--) {
+		uint8_t inbyte = *data++;
+		for (uint8_t i = 8; i; i--) {
+			uint8_t mix = (crc ^ inbyte) & 0x01;
+			crc >>= 1;
+			if (mix) {
+				crc ^= 0x8C;
+			}
+			inbyte >>= 1;
+		}
+	}
+
+	return crc;
+}
+
+
+uint16_t SimDevice::crc16(const uint8_t *data, uint16_t length, uint16_t crc) {
+	while (length--) {
+		crc ^= *data++;
+		for (uint8_t i = 0; i < 8; i++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+		}
+	}
+
+	return crc;
+}
+
+
+bool SimDevice::onReset(bool overdriveReset) {
+	if (!connected) {
+		return false;
+	}
+
+	if (!overdriveReset) {
+		mOverdrive = false;
+	} else if (!mOverdrive) {
+		/* A standard speed device sees an overdrive reset pulse as nothing more than a long write-zero slot */
+		mState = STATE_IDLE;
+		return false;
+	}
+
+	mState = STATE_ROM_COMMAND;
+	mBitCount = 0;
+	mShift = 0;
+	return true;
+}
+
+
+void SimDevice::transmit(const uint8_t *data, uint8_t length) {
+	if (length > sizeof(mTxBuffer)) {
+		length = sizeof(mTxBuffer);
+	}
+	if (length) {
+		memcpy(mTxBuffer, data, length);
+	}
+	mTxLength = length;
+	mTxIndex = 0;
+	mTxBit = 0;
+	mState = STATE_TRANSMIT;
+}
+
+
+void SimDevice::receive() {
+	mBitCount = 0;
+	mShift = 0;
+	mState = STATE_RECEIVE;
+}
+
+
+void SimDevice::idle() {
+	mState = STATE_IDLE;
+}
+
+
+void SimDevice::onRomCommand(uint8_t command) {
+	if (command != 0xA5) {
+		mResumeFlag = false;
+	}
+
+	mBitCount = 0;
+	mShift = 0;
+
+	switch (command) {
+		case 0x33:	/* Read ROM */
+			mResumeFlag = true;
+			selections++;
+			transmit(mRom, 8);
+			break;
+
+		case 0x69:	/* Overdrive Match ROM */
+			if (!supportsOverdrive) {
+				idle();
+				break;
+			}
+			/* Only the matching device stays in overdrive; the others go back to waiting for a standard reset */
+			mMatchRevert = !mOverdrive;
+			mOverdrive = true;
+			mState = STATE_MATCH;
+			break;
+
+		case 0x55:	/* Match ROM */
+			mMatchRevert = false;
+			mState = STATE_MATCH;
+			break;
+
+		case 0x3C:	/* Overdrive Skip ROM */
+			if (!supportsOverdrive) {
+				idle();
+				break;
+			}
+			mOverdrive = true;
+			mState = STATE_FUNCTION;
+			break;
+
+		case 0xCC:	/* Skip ROM */
+			mState = STATE_FUNCTION;
+			break;
+
+		case 0xEC:	/* Alarm Search */
+			if (!alarmCondition()) {
+				idle();
+				break;
+			}
+			/* Fall through */
+		case 0xF0:	/* Search ROM */
+			mSearchPhase = 0;
+			mState = STATE_SEARCH;
+			break;
+
+		case 0xA5:	/* Resume */
+			if (supportsResume && mResumeFlag) {
+				selections++;
+				mState = STATE_FUNCTION;
+			} else {
+				idle();
+			}
+			break;
+
+		default:
+			idle();
+			break;
+	}
+}
+
+
+uint8_t SimDevice::onSlot(uint8_t bit, bool overdriveSlot) {
+	if (!connected || overdriveSlot != mOverdrive) {
+		return 1;
+	}
+
+	uint8_t out = 1;
+
+	switch (mState) {
+		case STATE_IDLE:
+			break;
+
+		case STATE_ROM_COMMAND:
+		case STATE_FUNCTION:
+		case STATE_RECEIVE:
+			mShift |= (bit & 1) << mBitCount;
+			if (++mBitCount == 8) {
+				uint8_t value = mShift;
+				mBitCount = 0;
+				mShift = 0;
+				if (mState == STATE_ROM_COMMAND) {
+					onRomCommand(value);
+				} else if (mState == STATE_FUNCTION) {
+					onFunction(value);
+				} else {
+					onReceive(value);
+				}
+			}
+			break;
+
+		case STATE_MATCH: {
+			uint8_t expected = (mRom[mBitCount / 8] >> (mBitCount % 8)) & 1;
+			if ((bit & 1) != expected) {
+				if (mMatchRevert) {
+					mOverdrive = false;
+				}
+				idle();
+				break;
+			}
+			if (++mBitCount == 64) {
+				mBitCount = 0;
+				mResumeFlag = true;
+				selections++;
+				mState = STATE_FUNCTION;
+			}
+			break;
+		}
+
+		case STATE_SEARCH: {
+			uint8_t romBit = (mRom[mBitCount / 8] >> (mBitCount % 8)) & 1;
+			if (mSearchPhase == 0) {
+				out = romBit;
+				mSearchPhase = 1;
+			} else if (mSearchPhase == 1) {
+				out = romBit ^ 1;
+				mSearchPhase = 2;
+			} else {
+				mSearchPhase = 0;
+				if ((bit & 1) != romBit) {
+					idle();
+					break;
+				}
+				if (++mBitCount == 64) {
+					mBitCount = 0;
+					mResumeFlag = true;
+					selections++;
+					mState = STATE_FUNCTION;
+				}
+			}
+			break;
+		}
+
+		case STATE_TRANSMIT:
+			if (mTxIndex < mTxLength) {
+				out = (mTxBuffer[mTxIndex] >> mTxBit) & 1;
+				if (++mTxBit == 8) {
+					mTxBit = 0;
+					if (++mTxIndex == mTxLength) {
+						onTransmitted();
+					}
+				}
+			} else {
+				out = idleBit();
+			}
+			break;
+	}
+
+	if (corruptSlots && mState != STATE_IDLE) {
+		corruptSlots--;
+		out ^= 1;
+	}
+
+	return out;
+}
+
+
+bool SimBus::reset(bool overdrive) {
+	bool presence = false;
+
+	resets++;
+	for (uint8_t i = 0; i < mCount; i++) {
+		presence |= mDevices[i]->onReset(overdrive);
+	}
+
+	return presence;
+}
+
+
+uint8_t SimBus::slot(uint8_t bit, bool overdrive) {
+	uint8_t level = bit & 1;
+
+	slots++;
+	for (uint8_t i = 0; i < mCount; i++) {
+		level &= mDevices[i]->onSlot(bit, overdrive);
+	}
+
+	return level;
+}
+
+
+/* ---------------------------------------------------------------------------- */
+/* DS18B20                                                                      */
+/* ---------------------------------------------------------------------------- */
+
+static const uint8_t *ds18b20Rom(uint32_t serial) {
+	static uint8_t rom[8];
+	SimDevice::makeRom(rom, 0x28, serial);
+	return rom;
+}
+
+
+SimDS18B20::SimDS18B20(uint32_t serial, float celsius, uint8_t resolution, bool parasite) :
+	SimDevice(ds18b20Rom(serial)), conversions(0), mCelsius(celsius), mParasite(parasite), mReceived(0),
+	mCommand(0), mConverting(false), mConversionStart(0) {
+	/* Power-on scratchpad: 85°C, TH = 75°C, TL = 70°C */
+	const uint8_t defaults[9] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x00 };
+	memcpy(mScratchpad, defaults, sizeof(mScratchpad));
+	mScratchpad[4] = (uint8_t)(((resolution - 9) & 0x03) << 5) | 0x1F;
+	memcpy(mEeprom, mScratchpad + 2, 3);
+}
+
+
+uint32_t SimDS18B20::conversionTime() const {
+	return 750000UL >> (3 - ((mScratchpad[4] >> 5) & 0x03));
+}
+
+
+void SimDS18B20::finishConversion() {
+	if (!mConverting || (HostClock::now() - mConversionStart) < conversionTime()) {
+		return;
+	}
+
+	uint8_t resolution = (mScratchpad[4] >> 5) & 0x03;
+	int16_t raw = (int16_t)(mCelsius * 16.0f + (mCelsius < 0 ? -0.5f : 0.5f));
+	raw &= ~((1 << (3 - resolution)) - 1);
+
+	mScratchpad[0] = (uint8_t)raw;
+	mScratchpad[1] = (uint8_t)(raw >> 8);
+	mConverting = false;
+}
+
+
+void SimDS18B20::onFunction(uint8_t command) {
+	mCommand = command;
+
+	switch (command) {
+		case 0x44:	/* Convert T */
+			conversions++;
+			mConverting = true;
+			mConversionStart = HostClock::now();
+			transmit(NULL, 0);
+			break;
+
+		case 0xBE:	/* Read Scratchpad */
+			finishConversion();
+			mScratchpad[8] = crc8(mScratchpad, 8);
+			transmit(mScratchpad, 9);
+			break;
+
+		case 0x4E:	/* Write Scratchpad */
+			mReceived = 0;
+			receive();
+			break;
+
+		case 0x48:	/* Copy Scratchpad */
+			memcpy(mEeprom, mScratchpad + 2, 3);
+			transmit(NULL, 0);
+			break;
+
+		case 0xB8:	/* Recall E² */
+			memcpy(mScratchpad + 2, mEeprom, 3);
+			transmit(NULL, 0);
+			break;
+
+		case 0xB4:	/* Read Power Supply */
+			transmit(NULL, 0);
+			break;
+
+		default:
+			idle();
+			break;
+	}
+}
+
+
+void SimDS18B20::onReceive(uint8_t data) {
+	if (mReceived < 3) {
+		mScratchpad[2 + mReceived] = (mReceived == 2) ? ((data & 0x60) | 0x1F) : data;
+		mReceived++;
+	}
+}
+
+
+uint8_t SimDS18B20::idleBit() {
+	if (mCommand == 0x44) {
+		finishConversion();
+		return mConverting ? 0 : 1;
+	}
+
+	if (mCommand == 0xB4) {
+		return mParasite ? 0 : 1;
+	}
+
+	return 1;
+}
+
+
+bool SimDS18B20::alarmCondition() {
+	finishConversion();
+
+	int8_t whole = (int8_t)((int16_t)(mScratchpad[0] | (mScratchpad[1] << 8)) >> 4);
+	return whole >= (int8_t)mScratchpad[2] || whole <= (int8_t)mScratchpad[3];
+}
+
+
+static const uint8_t *switchRom(uint8_t family, uint32_t serial) {
+	static uint8_t rom[8];
+	SimDevice::makeRom(rom, family, serial);
+	return rom;
+}
+
+
+SimDS2408::SimDS2408(uint32_t serial) :
+	SimDevice(switchRom(0x29, serial)), inputs(0xFF), latch(0xFF), writes(0), mCommand(0), mReceived(0), mData(0) {
+}
+
+
+void SimDS2408::onFunction(uint8_t command) {
+	mCommand = command;
+
+	switch (command) {
+		case 0x5A:	/* Channel-Access Write */
+			mReceived = 0;
+			receive();
+			break;
+
+		case 0xF5:	/* Channel-Access Read */
+			sendBlock(true);
+			break;
+
+		default:
+			idle();
+			break;
+	}
+}
+
+
+void SimDS2408::onReceive(uint8_t data) {
+	if (mReceived++ == 0) {
+		mData = data;
+		return;
+	}
+
+	/* The second byte must be the inverse of the first; otherwise the device stops responding until the next reset */
+	if ((uint8_t)~data != mData) {
+		idle();
+		return;
+	}
+
+	latch = mData;
+	writes++;
+
+	uint8_t reply[2] = { 0xAA, (uint8_t)(latch & inputs) };
+	transmit(reply, 2);
+}
+
+
+void SimDS2408::onTransmitted() {
+	if (mCommand == 0x5A) {
+		mReceived = 0;
+		receive();
+	} else {
+		sendBlock(false);
+	}
+}
+
+
+/**
+ * 32 samples of the PIO pins, followed by the inverted CRC16 of the block; the first block's CRC includes the command
+ */
+void SimDS2408::sendBlock(bool first) {
+	uint8_t block[34];
+	uint16_t crc = 0;
+
+	if (first) {
+		uint8_t command = 0xF5;
+		crc = crc16(&command, 1);
+	}
+
+	for (uint8_t i = 0; i < 32; i++) {
+		block[i] = latch & inputs;
+	}
+	crc = ~crc16(block, 32, crc);
+	block[32] = (uint8_t)crc;
+	block[33] = (uint8_t)(crc >> 8);
+
+	transmit(block, 34);
+}
+
+
+SimDS2413::SimDS2413(uint32_t serial) :
+	SimDevice(switchRom(0x3A, serial)), inputs(0x03), latch(0x03), mCommand(0), mReceived(0), mData(0) {
+}
+
+
+void SimDS2413::onFunction(uint8_t command) {
+	mCommand = command;
+
+	switch (command) {
+		case 0x5A:	/* PIO Access Write */
+			mReceived = 0;
+			receive();
+			break;
+
+		case 0xF5:	/* PIO Access Read */
+			sendSample();
+			break;
+
+		default:
+			idle();
+			break;
+	}
+}
+
+
+void SimDS2413::onReceive(uint8_t data) {
+	if (mReceived++ == 0) {
+		mData = data;
+		return;
+	}
+
+	if ((uint8_t)~data != mData) {
+		idle();
+		return;
+	}
+
+	latch = mData & 0x03;
+
+	uint8_t pins = latch & inputs;
+	uint8_t status = (pins & 0x01) | ((latch & 0x01) << 1) | ((pins & 0x02) << 1) | ((latch & 0x02) << 2);
+	uint8_t reply[2] = { 0xAA, (uint8_t)(status | (~status << 4)) };
+	transmit(reply, 2);
+}
+
+
+void SimDS2413::onTransmitted() {
+	if (mCommand == 0x5A) {
+		mReceived = 0;
+		receive();
+	} else {
+		sendSample();
+	}
+}
+
+
+/**
+ * PIOA pin (bit 0) and latch (bit 1), PIOB pin (bit 2) and latch (bit 3), with their complement in the upper nibble
+ */
+void SimDS2413::sendSample() {
+	uint8_t pins = latch & inputs;
+	uint8_t status = (pins & 0x01) | ((latch & 0x01) << 1) | ((pins & 0x02) << 1) | ((latch & 0x02) << 2);
+	uint8_t sample = (uint8_t)(status | (~status << 4));
+
+	transmit(&sample, 1);
+}
+
+
+SimDS2431::SimDS2431(uint32_t serial) :
+	SimDevice(switchRom(0x2D, serial)), copies(0), mCommand(0), mReceived(0), mTargetAddress(0), mEndingOffset(0) {
+	supportsOverdrive = true;
+	memset(memory, 0xFF, sizeof(memory));
+	memset(mScratchpad, 0xFF, sizeof(mScratchpad));
+	memset(mHeader, 0, sizeof(mHeader));
+}
+
+
+void SimDS2431::onFunction(uint8_t command) {
+	mCommand = command;
+	mReceived = 0;
+
+	switch (command) {
+		case 0xF0:	/* Read Memory */
+		case 0x0F:	/* Write Scratchpad */
+		case 0x55:	/* Copy Scratchpad */
+			receive();
+			break;
+
+		case 0xAA: {	/* Read Scratchpad */
+			/* The data runs from the target address's offset through the ending offset */
+			uint8_t first = mTargetAddress & 0x07;
+			uint8_t last = mEndingOffset & 0x07;
+			uint8_t length = (last >= first) ? (last - first + 1) : 0;
+			uint8_t reply[3 + 8 + 2];
+			uint16_t crc;
+
+			reply[0] = (uint8_t)mTargetAddress;
+			reply[1] = (uint8_t)(mTargetAddress >> 8);
+			reply[2] = mEndingOffset;
+			memcpy(reply + 3, mScratchpad + first, length);
+			crc = crc16(&command, 1);
+			crc = ~crc16(reply, 3 + length, crc);
+			reply[3 + length] = (uint8_t)crc;
+			reply[4 + length] = (uint8_t)(crc >> 8);
+			transmit(reply, 5 + length);
+			break;
+		}
+
+		default:
+			idle();
+			break;
+	}
+}
+
+
+void SimDS2431::onReceive(uint8_t data) {
+	if (mReceived < 3) {
+		mHeader[mReceived++] = data;
+	} else {
+		mReceived++;
+	}
+	uint16_t address = mHeader[0] | (mHeader[1] << 8);
+
+	switch (mCommand) {
+		case 0xF0:
+			if (mReceived == 2) {
+				mTargetAddress = address;
+				sendMemory();
+			}
+			break;
+
+		case 0x0F:
+			if (mReceived == 2) {
+				mTargetAddress = address;
+				mEndingOffset = address & 0x07;
+			} else if (mReceived > 2) {
+				uint8_t offset = (mTargetAddress & 0x07) + (mReceived - 3);
+				if (offset < 8) {
+					mScratchpad[offset] = data;
+					mEndingOffset = offset;
+				}
+				if (offset == 7) {
+					/* A write to the end of the scratchpad is answered with the inverted CRC16 of everything sent */
+					uint8_t command = 0x0F;
+					uint8_t reply[2];
+					uint16_t crc = crc16(&command, 1);
+
+					crc = crc16(mHeader, 2, crc);
+					crc = ~crc16(mScratchpad + (mTargetAddress & 0x07), 8 - (mTargetAddress & 0x07), crc);
+					reply[0] = (uint8_t)crc;
+					reply[1] = (uint8_t)(crc >> 8);
+					transmit(reply, 2);
+				}
+			}
+			break;
+
+		case 0x55:
+			if (mReceived == 3) {
+				/* The authorization code must match the target address and ending offset of the scratchpad */
+				if (address != mTargetAddress || data != mEndingOffset || mEndingOffset != 7 || (address & 7)) {
+					idle();
+					break;
+				}
+				memcpy(memory + address, mScratchpad, 8);
+				copies++;
+				mEndingOffset |= 0x80;
+
+				/* After tPROG, the device answers read slots with alternating 1s and 0s */
+				const uint8_t done[4] = { 0xAA, 0xAA, 0xAA, 0xAA };
+				transmit(done, 4);
+			}
+			break;
+	}
+}
+
+
+void SimDS2431::onTransmitted() {
+	if (mCommand == 0xF0) {
+		sendMemory();
+	}
+}
+
+
+/**
+ * Memory is read up to the end of the array, in chunks the transmit buffer can hold; past the end, the bus reads 1s
+ */
+void SimDS2431::sendMemory() {
+	uint16_t length = (mTargetAddress < sizeof(memory)) ? sizeof(memory) - mTargetAddress : 0;
+
+	if (length > 32) {
+		length = 32;
+	}
+	transmit(memory + mTargetAddress, (uint8_t)length);
+	mTargetAddress += length;
+}
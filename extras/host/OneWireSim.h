@@ -0,0 +1,254 @@
+/**
+ * \file OneWireSim.h
+ * A slot-level simulation of a 1-Wire bus and the devices attached to it. Each device implements the ROM function
+ * layer (search, alarm search, match/skip/resume and their overdrive forms) in SimDevice, while subclasses model the
+ * device-specific memory/function layer.
+ */
+
+#ifndef _DS2482OW__HOST_ONEWIRESIM_H__
+#define _DS2482OW__HOST_ONEWIRESIM_H__
+
+#include "Arduino.h"
+
+#define SIM_MAX_DEVICES		64
+
+/**
+ * \class SimDevice	Base class for a simulated 1-Wire slave device.
+ */
+class SimDevice {
+public:
+	SimDevice(const uint8_t rom[8]);
+	virtual ~SimDevice() {}
+
+	/** Builds a ROM with a valid CRC byte from a family code and a 48-bit serial number. */
+	static void makeRom(uint8_t rom[8], uint8_t family, uint32_t serial);
+
+	/** Maxim 1-Wire CRC8, used by the simulator to build ROMs and scratchpads independently of the library. */
+	static uint8_t crc8(const uint8_t *data, uint8_t length);
+
+	/** Maxim 1-Wire CRC16 (not inverted). */
+	static uint16_t crc16(const uint8_t *data, uint16_t length, uint16_t crc = 0);
+
+	const uint8_t *rom() const { return mRom; }
+
+	/** Handles a reset pulse; returns true if the device answers with a presence pulse. */
+	bool onReset(bool overdriveReset);
+
+	/** Handles one time slot in which the master writes \p bit; returns the level the device leaves on the bus. */
+	uint8_t onSlot(uint8_t bit, bool overdriveSlot);
+
+	/** Simulated devices may be disconnected from the bus without being removed from it. */
+	bool connected;
+
+	/** Makes the next N responding time slots return garbage, to exercise CRC and retry paths. */
+	uint8_t corruptSlots;
+
+	/** Number of ROM commands which successfully selected this device. */
+	uint32_t selections;
+
+	/** The device supports the Resume (0xA5) ROM command. */
+	bool supportsResume;
+
+	/** The device supports the overdrive ROM commands. */
+	bool supportsOverdrive;
+
+protected:
+	/** Called when a function command byte has been received after the device was selected. */
+	virtual void onFunction(uint8_t command) = 0;
+
+	/** Called for each byte received in receive mode. */
+	virtual void onReceive(uint8_t data) { (void)data; }
+
+	/** Called when the transmit buffer has been emptied; may queue more data. */
+	virtual void onTransmitted() {}
+
+	/** The level driven during read slots once the transmit buffer has run dry. */
+	virtual uint8_t idleBit() { return 1; }
+
+	/** Whether the device takes part in an Alarm Search (0xEC). */
+	virtual bool alarmCondition() { return false; }
+
+	/** Switches the device to transmitting the specified bytes. */
+	void transmit(const uint8_t *data, uint8_t length);
+
+	/** Switches the device to receiving bytes, which are passed to onReceive(). */
+	void receive();
+
+	/** Stops the device from taking part in bus traffic until the next reset. */
+	void idle();
+
+	uint8_t mRom[8];
+
+private:
+	enum State {
+		STATE_IDLE,
+		STATE_ROM_COMMAND,
+		STATE_MATCH,
+		STATE_SEARCH,
+		STATE_FUNCTION,
+		STATE_RECEIVE,
+		STATE_TRANSMIT
+	};
+
+	void onRomCommand(uint8_t command);
+
+	State mState;
+	bool mOverdrive;
+	bool mMatchRevert;
+	bool mResumeFlag;
+
+	uint8_t mBitCount;
+	uint8_t mShift;
+	uint8_t mSearchPhase;
+
+	uint8_t mTxBuffer[40];
+	uint8_t mTxLength;
+	uint8_t mTxIndex;
+	uint8_t mTxBit;
+};
+
+
+/**
+ * \class SimBus	A single 1-Wire segment; the wired-AND of all attached devices.
+ */
+class SimBus {
+public:
+	SimBus() : resets(0), slots(0), mCount(0) {}
+
+	void attach(SimDevice *device) { if (mCount < SIM_MAX_DEVICES) { mDevices[mCount++] = device; } }
+	uint8_t count() const { return mCount; }
+	SimDevice *device(uint8_t i) { return mDevices[i]; }
+
+	bool reset(bool overdrive);
+	uint8_t slot(uint8_t bit, bool overdrive);
+
+	uint32_t resets;		/*!< Number of reset pulses generated on the segment */
+	uint32_t slots;			/*!< Number of time slots generated on the segment */
+
+private:
+	SimDevice *mDevices[SIM_MAX_DEVICES];
+	uint8_t mCount;
+};
+
+
+/**
+ * \class SimDS18B20	A DS18B20 programmable resolution thermometer (family 0x28).
+ */
+class SimDS18B20 : public SimDevice {
+public:
+	SimDS18B20(uint32_t serial, float celsius = 21.5f, uint8_t resolution = 12, bool parasite = false);
+
+	void setTemperature(float celsius) { mCelsius = celsius; }
+
+	/** Conversions which have been started on this device. */
+	uint32_t conversions;
+
+protected:
+	void onFunction(uint8_t command);
+	void onReceive(uint8_t data);
+	uint8_t idleBit();
+	bool alarmCondition();
+
+private:
+	void finishConversion();
+	uint32_t conversionTime() const;
+
+	float mCelsius;
+	bool mParasite;
+	uint8_t mScratchpad[9];
+	uint8_t mEeprom[3];
+	uint8_t mReceived;
+	uint8_t mCommand;
+	bool mConverting;
+	uint32_t mConversionStart;
+};
+
+
+/**
+ * \class SimDS2408	A DS2408 8-channel addressable switch (family 0x29), supporting Channel-Access Read and Write.
+ */
+class SimDS2408 : public SimDevice {
+public:
+	SimDS2408(uint32_t serial);
+
+	/** The levels external circuitry drives the PIO pins to; a pin reads low if either side pulls it low. */
+	uint8_t inputs;
+
+	/** The output latch state. */
+	uint8_t latch;
+
+	/** Channel-Access Write bytes which were accepted. */
+	uint32_t writes;
+
+protected:
+	void onFunction(uint8_t command);
+	void onReceive(uint8_t data);
+	void onTransmitted();
+
+private:
+	void sendBlock(bool first);
+
+	uint8_t mCommand;
+	uint8_t mReceived;
+	uint8_t mData;
+};
+
+
+/**
+ * \class SimDS2413	A DS2413 dual-channel addressable switch (family 0x3A).
+ */
+class SimDS2413 : public SimDevice {
+public:
+	SimDS2413(uint32_t serial);
+
+	/** The levels external circuitry drives PIOA (bit 0) and PIOB (bit 1) to. */
+	uint8_t inputs;
+
+	/** The output latch state of PIOA (bit 0) and PIOB (bit 1). */
+	uint8_t latch;
+
+protected:
+	void onFunction(uint8_t command);
+	void onReceive(uint8_t data);
+	void onTransmitted();
+
+private:
+	void sendSample();
+
+	uint8_t mCommand;
+	uint8_t mReceived;
+	uint8_t mData;
+};
+
+
+/**
+ * \class SimDS2431	A DS2431 1024-bit 1-Wire EEPROM (family 0x2D): 128 bytes of memory in 8-byte rows, followed by
+ *					the 16 bytes of register and protection pages.
+ */
+class SimDS2431 : public SimDevice {
+public:
+	SimDS2431(uint32_t serial);
+
+	/** The memory array, including the register page at 0x80. */
+	uint8_t memory[0x90];
+
+	/** Copy Scratchpad commands which programmed a row. */
+	uint32_t copies;
+
+protected:
+	void onFunction(uint8_t command);
+	void onReceive(uint8_t data);
+	void onTransmitted();
+
+private:
+	void sendMemory();
+
+	uint8_t mCommand;
+	uint8_t mReceived;
+	uint8_t mHeader[3];
+	uint8_t mScratchpad[8];
+	uint16_t mTargetAddress;
+	uint8_t mEndingOffset;
+};
+
+#endif	/* _DS2482OW__HOST_ONEWIRESIM_H__ */
@@ -0,0 +1,83 @@
+/**
+ * \file Wire.h
+ * Host-side mock of the Arduino \c TwoWire class. Transactions are routed to simulated I²C peripherals, every
+ * transaction is counted, and the simulated clock is advanced by the time the transfer would take on a real bus at
+ * the configured clock rate.
+ */
+
+#ifndef _DS2482OW__HOST_WIRE_H__
+#define _DS2482OW__HOST_WIRE_H__
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH	32
+
+/**
+ * \class I2CPeripheral	Interface implemented by simulated devices attached to a mock \c TwoWire bus.
+ */
+class I2CPeripheral {
+public:
+	virtual ~I2CPeripheral() {}
+
+	/** Handles the bytes of one master-write transaction. Returns false to NACK the transfer. */
+	virtual bool i2cWrite(const uint8_t *data, uint8_t length) = 0;
+
+	/** Supplies the next byte of a master-read transaction. */
+	virtual uint8_t i2cRead() = 0;
+};
+
+/**
+ * \struct TwoWireCounters	Deterministic transaction accounting for the mock bus.
+ */
+struct TwoWireCounters {
+	uint32_t writes;		/*!< Number of write transactions (\c endTransmission calls) */
+	uint32_t reads;			/*!< Number of read transactions (\c requestFrom calls) */
+	uint32_t bytes;			/*!< Number of payload bytes moved in either direction */
+	uint32_t nacks;			/*!< Number of transactions which were not acknowledged */
+};
+
+class TwoWire {
+public:
+	TwoWire();
+
+	void begin() {}
+	void setClock(uint32_t hz) { mClock = hz; }
+	uint32_t getClock() const { return mClock; }
+
+	void beginTransmission(uint8_t address);
+	void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+	uint8_t endTransmission(bool sendStop = true);
+	size_t write(uint8_t data);
+	uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = 1);
+	uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity); }
+	int available() { return mRxLength - mRxIndex; }
+	int read();
+
+	/** Attaches a simulated peripheral at a 7-bit address. */
+	void attach(uint8_t address, I2CPeripheral *device);
+
+	/** Transaction counters accumulated since the last call to resetCounters(). */
+	const TwoWireCounters &counters() const { return mCounters; }
+	void resetCounters() { memset(&mCounters, 0, sizeof(mCounters)); }
+	uint32_t transactions() const { return mCounters.writes + mCounters.reads; }
+
+private:
+	void busTime(uint8_t bytes);
+
+	I2CPeripheral *mDevices[128];
+	uint32_t mClock;
+	TwoWireCounters mCounters;
+
+	uint8_t mTxAddress;
+	uint8_t mTxBuffer[BUFFER_LENGTH];
+	uint8_t mTxLength;
+
+	uint8_t mRxBuffer[BUFFER_LENGTH];
+	uint8_t mRxLength;
+	uint8_t mRxIndex;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif	/* _DS2482OW__HOST_WIRE_H__ */
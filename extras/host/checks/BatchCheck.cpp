@@ -0,0 +1,70 @@
+/**
+ * \file BatchCheck.cpp
+ * Checks that OneWireBatch reports a bridge which stops acknowledging mid-transaction as ONEWIRE_ASYNC_ERROR_BRIDGE,
+ * and that the fault is not carried over into the next transaction.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+#include "OneWireBatch.h"
+#include "HostCheck.h"
+
+
+static const uint8_t readScratchpad = 0xBE;
+
+
+/**
+ * Passes everything through to the simulated bridge, except for the Write Byte of the Read Scratchpad command, which
+ * is NACKed while 'failing' is set.
+ */
+class FaultyBridge : public I2CPeripheral {
+public:
+	FaultyBridge() : failing(false) {}
+
+	bool i2cWrite(const uint8_t *data, uint8_t length) {
+		if (failing && length == 2 && data[0] == 0xA5 && data[1] == readScratchpad) {
+			return false;
+		}
+		return bridge.i2cWrite(data, length);
+	}
+
+	uint8_t i2cRead() {
+		return bridge.i2cRead();
+	}
+
+	DS2482Sim bridge;
+	bool failing;
+};
+
+
+int main() {
+	static FaultyBridge device;
+	Wire.attach(0x18, &device);
+
+	SimDS18B20 sensor(1);
+	device.bridge.bus().attach(&sensor);
+
+	OneWire bus(0);
+	bus.deviceReset();
+
+	OneWireBatch batch(bus);
+	uint8_t scratchpad[9];
+	OneWireTransaction txn = { ONEWIRE_TXN_RESET, sensor.rom(), &readScratchpad, 1, scratchpad, 9 };
+
+	/* A healthy transaction succeeds, even if a byte needed the busy retry */
+	CHECK(batch.execute(txn) == ONEWIRE_ASYNC_ERROR_NONE);
+	CHECK(OneWire::crc8(scratchpad, 9) == 0);
+
+	/* The bridge refuses the function command, the retry included: a bridge fault, not a timeout or a success */
+	device.failing = true;
+	CHECK(batch.execute(txn) == ONEWIRE_ASYNC_ERROR_BRIDGE);
+	CHECK(bus.getError() & DS2482_ERROR_I2C);
+
+	/* Once the bridge answers again, so does the next transaction */
+	device.failing = false;
+	CHECK(batch.execute(txn) == ONEWIRE_ASYNC_ERROR_NONE);
+	CHECK(bus.getError() == 0);
+
+	return CHECK_RESULT;
+}
@@ -0,0 +1,55 @@
+/**
+ * \file BusManagerCheck.cpp
+ * Checks that OneWireBusManager::abort() leaves its bridges ready for new jobs: a job submitted after an abort must run
+ * to completion on its own, rather than pick up the aborted transaction's result.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+#include "OneWireBusManager.h"
+#include "HostCheck.h"
+
+
+static const uint8_t readScratchpad = 0xBE;
+
+
+int main() {
+	static DS2482Sim bridge;
+	Wire.attach(0x18, &bridge);
+
+	SimDS18B20 sensor(1);
+	bridge.bus().attach(&sensor);
+
+	OneWire bus(0);
+	bus.deviceReset();
+
+	OneWireAsync engine(bus);
+	OneWireBusManager manager;
+	CHECK(manager.addBridge(engine) == 0);
+
+	uint8_t first[9];
+	uint8_t second[9];
+	OneWireJob aborted = { { ONEWIRE_TXN_RESET, sensor.rom(), &readScratchpad, 1, first, 9 }, ONEWIRE_JOB_ANY_CHANNEL,
+		0, NULL, 0, 0, NULL };
+	OneWireJob next = { { ONEWIRE_TXN_RESET, sensor.rom(), &readScratchpad, 1, second, 9 }, ONEWIRE_JOB_ANY_CHANNEL,
+		0, NULL, 0, 0, NULL };
+
+	/* Abort while the first job is on the wire */
+	CHECK(manager.submit(0, aborted));
+	CHECK(manager.poll() == 1);
+	manager.abort();
+	CHECK(aborted.result == ONEWIRE_ASYNC_ERROR);
+
+	/* The bridge may still be clocking out the aborted command; the next job must wait for it, then run normally */
+	CHECK(manager.submit(0, next));
+	manager.flush();
+	CHECK(next.result == ONEWIRE_ASYNC_DONE);
+	CHECK(OneWire::crc8(second, 9) == 0);
+
+	/* Aborting with nothing queued, then polling, must be harmless */
+	manager.abort();
+	CHECK(manager.poll() == 0);
+
+	return CHECK_RESULT;
+}
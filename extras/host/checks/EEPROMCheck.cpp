@@ -0,0 +1,51 @@
+/**
+ * \file EEPROMCheck.cpp
+ * Checks that OneWireEEPROM::write() keeps to the data memory, and that the register pages can only be written
+ * through writeRegisters().
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+#include "OneWireEEPROM.h"
+#include "HostCheck.h"
+
+
+int main() {
+	static DS2482Sim bridge;
+	Wire.attach(0x18, &bridge);
+
+	SimDS2431 device(1);
+	bridge.bus().attach(&device);
+
+	OneWire bus(0);
+	bus.deviceReset();
+
+	OneWireEEPROM eeprom(bus, device.rom());
+	uint8_t data[20];
+	uint8_t check[20];
+
+	for (uint8_t i = 0; i < sizeof(data); i++) {
+		data[i] = 0x40 + i;
+	}
+
+	/* A range which crosses rows, with partial rows at both ends */
+	CHECK(eeprom.write(0x05, data, sizeof(data)) == ONEWIRE_EEPROM_OK);
+	CHECK(eeprom.read(0x05, check, sizeof(check)) == ONEWIRE_EEPROM_OK);
+	CHECK(memcmp(data, check, sizeof(data)) == 0);
+	CHECK(device.memory[0x04] == 0xFF && device.memory[0x19] == 0xFF);
+
+	/* write() must not reach the register page, not even with a range which only ends in it */
+	uint32_t copies = device.copies;
+	CHECK(eeprom.write(0x80, data, 1) == ONEWIRE_EEPROM_RANGE);
+	CHECK(eeprom.write(0x7C, data, 8) == ONEWIRE_EEPROM_RANGE);
+	CHECK(device.copies == copies);
+
+	/* writeRegisters() only takes the register page */
+	CHECK(eeprom.writeRegisters(0x7F, data, 1) == ONEWIRE_EEPROM_RANGE);
+	CHECK(eeprom.writeRegisters(0x8F, data, 2) == ONEWIRE_EEPROM_RANGE);
+	CHECK(eeprom.writeRegisters(0x86, data, 2) == ONEWIRE_EEPROM_OK);
+	CHECK(device.memory[0x86] == data[0] && device.memory[0x87] == data[1]);
+
+	return CHECK_RESULT;
+}
@@ -0,0 +1,36 @@
+/**
+ * \file HostCheck.h
+ * A minimal assertion helper for the host checks in this directory: each check is a small program, built by
+ * scripts/run_host_checks.sh against the library and the simulator, which exits with a non-zero status if any of its
+ * CHECK()s failed.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__HOST_HOSTCHECK_H__
+#define _DS2482OW__HOST_HOSTCHECK_H__
+
+#include <stdio.h>
+
+/** The number of CHECK()s which failed so far. */
+static int hostCheckFailures = 0;
+
+/**
+ * \def CHECK	Checks a condition, and reports it with its file and line if it does not hold.
+ */
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			hostCheckFailures++; \
+		} \
+	} while (0)
+
+/**
+ * \def CHECK_RESULT	The exit status of a check program: 0 if every CHECK() held.
+ */
+#define CHECK_RESULT	(hostCheckFailures ? 1 : 0)
+
+#endif	/* _DS2482OW__HOST_HOSTCHECK_H__ */
@@ -0,0 +1,68 @@
+/**
+ * \file RetryCheck.cpp
+ * Checks that OneWireRetry does not accept a response which reads as all zeros, and so passes its CRC8.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+#include "OneWireRetry.h"
+#include "HostCheck.h"
+
+
+static const uint8_t readScratchpad = 0xBE;
+
+
+/**
+ * Passes everything through to the simulated bridge, except that reads of the data register return 0 while 'stuck'
+ * is set, as they do when the 1-Wire line is held low.
+ */
+class StuckBridge : public I2CPeripheral {
+public:
+	StuckBridge() : stuck(false), mData(false) {}
+
+	bool i2cWrite(const uint8_t *data, uint8_t length) {
+		/* Set Read Pointer to the data register; every other command moves the read pointer elsewhere */
+		mData = (length == 2 && data[0] == 0xE1 && data[1] == 0xE1);
+		return bridge.i2cWrite(data, length);
+	}
+
+	uint8_t i2cRead() {
+		uint8_t data = bridge.i2cRead();
+		return (stuck && mData) ? 0 : data;
+	}
+
+	DS2482Sim bridge;
+	bool stuck;
+
+private:
+	bool mData;
+};
+
+
+int main() {
+	static StuckBridge device;
+	Wire.attach(0x18, &device);
+
+	SimDS18B20 sensor(1);
+	device.bridge.bus().attach(&sensor);
+
+	OneWire bus(0);
+	bus.deviceReset();
+
+	OneWireDeviceHealth health[1];
+	OneWireRetry retry(bus, health, 1);
+	uint8_t scratchpad[9];
+
+	/* Nine zero bytes have a CRC8 of 0, but are not a response */
+	device.stuck = true;
+	CHECK(retry.transfer(sensor.rom(), &readScratchpad, 1, scratchpad, 9) == ONEWIRE_RETRY_CRC);
+	CHECK(retry.isDeferred(sensor.rom()));
+
+	device.stuck = false;
+	retry.release(sensor.rom());
+	CHECK(retry.transfer(sensor.rom(), &readScratchpad, 1, scratchpad, 9) == ONEWIRE_RETRY_OK);
+	CHECK(OneWire::crc8(scratchpad, 9) == 0);
+
+	return CHECK_RESULT;
+}
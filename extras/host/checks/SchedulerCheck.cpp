@@ -0,0 +1,65 @@
+/**
+ * \file SchedulerCheck.cpp
+ * Checks that OneWireConversionScheduler does not take a scratchpad which reads as all zeros, and so passes its CRC,
+ * for a reading of 0 °C.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+#include "OneWireConversionScheduler.h"
+#include "HostCheck.h"
+
+
+/**
+ * Passes everything through to the simulated bridge, except that reads of the data register return 0 while 'stuck'
+ * is set, as they do when the 1-Wire line is held low.
+ */
+class StuckBridge : public I2CPeripheral {
+public:
+	StuckBridge() : stuck(false), mData(false) {}
+
+	bool i2cWrite(const uint8_t *data, uint8_t length) {
+		/* Set Read Pointer to the data register; every other command moves the read pointer elsewhere */
+		mData = (length == 2 && data[0] == 0xE1 && data[1] == 0xE1);
+		return bridge.i2cWrite(data, length);
+	}
+
+	uint8_t i2cRead() {
+		uint8_t data = bridge.i2cRead();
+		return (stuck && mData) ? 0 : data;
+	}
+
+	DS2482Sim bridge;
+	bool stuck;
+
+private:
+	bool mData;
+};
+
+
+int main() {
+	static StuckBridge device;
+	Wire.attach(0x18, &device);
+
+	SimDS18B20 sensor(1);
+	device.bridge.bus().attach(&sensor);
+
+	OneWire bus(0);
+	bus.deviceReset();
+
+	OneWireSensor sensors[1];
+	OneWireConversionScheduler scheduler(bus, sensors, 1);
+	CHECK(scheduler.addSensor(sensor.rom()) == 0);
+
+	/* Nine zero bytes have a CRC of 0, but are not a scratchpad */
+	device.stuck = true;
+	CHECK(scheduler.runConversion() == 0);
+	CHECK(scheduler.getSensor(0).state == ONEWIRE_SENSOR_ERROR);
+
+	device.stuck = false;
+	CHECK(scheduler.runConversion() == 1);
+	CHECK(scheduler.getSensor(0).state == ONEWIRE_SENSOR_READY);
+
+	return CHECK_RESULT;
+}
@@ -0,0 +1,54 @@
+/**
+ * \file main.cpp
+ * Entry point for running a sketch on the host: attaches a simulated DS2482-100 at address 0x18 to the mock \c Wire
+ * bus, puts a number of simulated DS18B20 sensors on its 1-Wire line, along with a DS2408 and a DS2413 switch and a
+ * DS2431 EEPROM, then calls the sketch's \c setup() and \c loop().
+ *
+ * Usage: \c benchmark [sensors] [loops] -- by default, 8 sensors and a single call to \c loop().
+ */
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS2482Sim.h"
+
+/**
+ * \def SIM_PERIPHERALS	The number of devices other than sensors which are put on the bus.
+ */
+#define SIM_PERIPHERALS		3
+
+void setup();
+void loop();
+
+
+int main(int argc, char **argv) {
+	int sensors = (argc > 1) ? atoi(argv[1]) : 8;
+	int loops = (argc > 2) ? atoi(argv[2]) : 1;
+
+	if (sensors < 0 || sensors > SIM_MAX_DEVICES - SIM_PERIPHERALS) {
+		fprintf(stderr, "sensors must be between 0 and %d\n", SIM_MAX_DEVICES - SIM_PERIPHERALS);
+		return 1;
+	}
+
+	static DS2482Sim bridge;
+	Wire.attach(0x18, &bridge);
+
+	for (int i = 0; i < sensors; i++) {
+		/* Spread the temperatures out a little, so that every sensor reads back something different */
+		bridge.bus().attach(new SimDS18B20(i + 1, 20.0f + i * 0.5f));
+	}
+
+	/* One of each of the other device models, so that their code paths run as well */
+	bridge.bus().attach(new SimDS2408(1));
+	bridge.bus().attach(new SimDS2413(1));
+	bridge.bus().attach(new SimDS2431(1));
+
+	setup();
+	for (int i = 0; i < loops; i++) {
+		loop();
+	}
+
+	fflush(stdout);
+	return 0;
+}
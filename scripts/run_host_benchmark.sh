@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+#
+# Script to build the Benchmark example against the host-side simulator in extras/host, and run it.
+# Any arguments are passed on to the benchmark: [sensors] [loops].
+#
+# Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+#
+#
+
+set -e
+
+# DEFINE SOME IMPORTANT CONSTANTS #
+PRJ_ROOT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+PRJ_SRC_DIR="${PRJ_ROOT_DIR}/src"
+PRJ_HOST_DIR="${PRJ_ROOT_DIR}/extras/host"
+PRJ_SKETCH="${PRJ_ROOT_DIR}/examples/Benchmark/Benchmark.ino"
+PRJ_BUILD_DIR="${TMPDIR:-/tmp}/ds2482_onewire_host"
+
+CXX="${CXX:-g++}"
+CXXFLAGS="${CXXFLAGS:--O2 -Wall -Wextra}"
+
+mkdir -p "${PRJ_BUILD_DIR}"
+
+# BUILD THE SKETCH, THE LIBRARY AND THE SIMULATOR AS ONE HOST PROGRAM #
+${CXX} -std=gnu++11 ${CXXFLAGS} -DARDUINO=10800 -DDS2482OW_HOST -DONEWIRE_ENABLE_STATS=1 \
+	-I"${PRJ_HOST_DIR}" -I"${PRJ_SRC_DIR}" \
+	-include Arduino.h -x c++ "${PRJ_SKETCH}" -x none \
+	"${PRJ_HOST_DIR}"/*.cpp "${PRJ_SRC_DIR}"/*.cpp \
+	-o "${PRJ_BUILD_DIR}/benchmark"
+
+"${PRJ_BUILD_DIR}/benchmark" "$@"
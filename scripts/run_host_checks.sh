@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+#
+# Script to build every check in extras/host/checks against the library and the host-side simulator, and run them.
+# Exits with a non-zero status if any check fails to build or to pass.
+#
+# Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+#
+#
+
+set -e
+
+# DEFINE SOME IMPORTANT CONSTANTS #
+PRJ_ROOT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+PRJ_SRC_DIR="${PRJ_ROOT_DIR}/src"
+PRJ_HOST_DIR="${PRJ_ROOT_DIR}/extras/host"
+PRJ_CHECK_DIR="${PRJ_HOST_DIR}/checks"
+PRJ_BUILD_DIR="${TMPDIR:-/tmp}/ds2482_onewire_host"
+
+CXX="${CXX:-g++}"
+CXXFLAGS="${CXXFLAGS:--O2 -Wall -Wextra}"
+
+# THE SIMULATOR, WITHOUT THE SKETCH ENTRY POINT #
+SIM_SOURCES=""
+for src in "${PRJ_HOST_DIR}"/*.cpp; do
+	if [ "$(basename "${src}")" != "main.cpp" ]; then
+		SIM_SOURCES="${SIM_SOURCES} ${src}"
+	fi
+done
+
+mkdir -p "${PRJ_BUILD_DIR}"
+
+FAILED=0
+for check in "${PRJ_CHECK_DIR}"/*.cpp; do
+	name="$(basename "${check}" .cpp)"
+
+	${CXX} -std=gnu++11 ${CXXFLAGS} -DARDUINO=10800 -DDS2482OW_HOST \
+		-I"${PRJ_HOST_DIR}" -I"${PRJ_CHECK_DIR}" -I"${PRJ_SRC_DIR}" \
+		"${check}" ${SIM_SOURCES} "${PRJ_SRC_DIR}"/*.cpp \
+		-o "${PRJ_BUILD_DIR}/${name}"
+
+	if "${PRJ_BUILD_DIR}/${name}"; then
+		echo "${name}: passed"
+	else
+		echo "${name}: FAILED"
+		FAILED=1
+	fi
+done
+
+exit ${FAILED}
@@ -9,16 +9,24 @@
 /* INCLUDES                                                                     */
 /* ---------------------------------------------------------------------------- */
 #include "OneWire.h"
-#include <Wire.h>
+#include <string.h>
+
+/* Statistics helpers, which compile to nothing unless ONEWIRE_ENABLE_STATS is set */
+#if ONEWIRE_ENABLE_STATS
+#define ONEWIRE_STAT(counter)			(mStats.counter++)
+#define ONEWIRE_STAT_TIMER(name)		uint32_t name = micros()
+#define ONEWIRE_STAT_TIME(op, name)		statTime(op, name)
+#else
+#define ONEWIRE_STAT(counter)
+#define ONEWIRE_STAT_TIMER(name)
+#define ONEWIRE_STAT_TIME(op, name)
+#endif
 
 /**
  * Constructor with no parameters for compatability with OneWire lib
  */
 OneWire::OneWire() {
-	/* Address is determined by two pins on the DS2482 AD1/AD0 */
-	/* Pass 0b00, 0b01, 0b10 or 0b11 */
-	mAddress = 0x18;
-	mError = 0;
+	init(0x18, Wire);
 	Wire.begin();
 }
 
@@ -26,12 +34,50 @@ OneWire::OneWire() {
 OneWire::OneWire(uint8_t address) {
 	/* Address is determined by two pins on the DS2482 AD1/AD0 */
 	/* Pass 0b00, 0b01, 0b10 or 0b11 */
-	mAddress = 0x18 | address;
-	mError = 0;
+	init(0x18 | address, Wire);
 	Wire.begin();
 }
 
 
+OneWire::OneWire(uint8_t address, OneWireI2C &wire) {
+	/* The bus belongs to the sketch, which has already set it up (or will, before the bridge is used) */
+	init(0x18 | address, wire);
+}
+
+
+void OneWire::init(uint8_t address, OneWireI2C &wire) {
+	mWire = &wire;
+	mAddress = address;
+	mError = 0;
+	mReadPointer = DS2482_POINTER_UNKNOWN;
+	mConfig = DS2482_CONFIG_UNKNOWN;
+	mProfile = ONEWIRE_BUS_PROFILE;
+	mPullupActive = 0;
+	mPullupStart = 0;
+	mPullupWindow = 0;
+	mChannel = DS2482_CHANNEL_UNKNOWN;
+	mCommandStart = 0;
+	mCommandDuration = 0;
+	mPollInterval = ONEWIRE_POLL_INTERVAL;
+	mLastPollCount = 0;
+	mTotalPollCount = 0;
+	mLastRomValid = 0;
+	mWaitHook = 0;
+	mWaitContext = 0;
+	mLockHook = 0;
+	mLockContext = 0;
+#if ONEWIRE_ENABLE_STATS
+	resetStats();
+#endif
+	wireResetSearch();
+}
+
+
+OneWireI2C &OneWire::getWire() {
+	return *mWire;
+}
+
+
 uint8_t OneWire::getAddress() {
 	return mAddress;
 }
@@ -40,27 +86,242 @@ uint8_t OneWire::getError() {
 	return mError;
 }
 
+void OneWire::clearError() {
+	mError = 0;
+}
+
+uint8_t OneWire::getChannel() {
+	return mChannel;
+}
+
+void OneWire::setPollInterval(uint16_t interval) {
+	mPollInterval = interval;
+}
+
+uint16_t OneWire::getLastPollCount() {
+	return mLastPollCount;
+}
+
+uint32_t OneWire::getTotalPollCount() {
+	return mTotalPollCount;
+}
+
+void OneWire::setWaitHook(OneWireWaitHook hook, void *context) {
+	mWaitHook = hook;
+	mWaitContext = context;
+}
+
+void OneWire::pause(uint32_t duration) {
+	if (mWaitHook) {
+		mWaitHook(duration, mWaitContext);
+		return;
+	}
+
+	/* delayMicroseconds() is only accurate up to 16383µs on AVR */
+	while (duration > 16000) {
+		delayMicroseconds(16000);
+		duration -= 16000;
+	}
+	delayMicroseconds(duration);
+}
+
+void OneWire::yieldWait(uint32_t duration, void *context) {
+	uint32_t start = micros();
+
+	(void)context;
+	while (micros() - start < duration) {
+		yield();
+	}
+}
+
+#if ONEWIRE_HAVE_SLEEP_WAIT
+void OneWire::sleepWait(uint32_t duration, void *context) {
+#if defined(INC_FREERTOS_H)
+	uint32_t start = micros();
+
+	/*
+	 * Rounded up, in microseconds against the tick rate: portTICK_PERIOD_MS is 0 above 1 kHz, and a wait shorter than
+	 * a tick must still sleep rather than spin
+	 */
+	TickType_t ticks = (TickType_t)(((uint64_t)duration * configTICK_RATE_HZ + 999999UL) / 1000000UL);
+
+	if (ticks) {
+		vTaskDelay(ticks);
+	}
+
+	/* vTaskDelay() can return up to a tick early; give what is left to other tasks of the same priority */
+	uint32_t elapsed = micros() - start;
+	if (elapsed < duration) {
+		yieldWait(duration - elapsed, context);
+	}
+#else
+	(void)context;
+	k_usleep(duration);
+#endif
+}
+#endif
+
+void OneWire::setLockHook(OneWireLockHook hook, void *context) {
+	mLockHook = hook;
+	mLockContext = context;
+}
+
+void OneWire::lock() {
+	if (mLockHook) {
+		mLockHook(1, mLockContext);
+	}
+}
+
+void OneWire::unlock() {
+	if (mLockHook) {
+		mLockHook(0, mLockContext);
+	}
+}
+
+void OneWire::noteCrcError() {
+	ONEWIRE_STAT(crcErrors);
+}
+
+#if ONEWIRE_ENABLE_STATS
+const OneWireStats &OneWire::getStats() {
+	return mStats;
+}
+
+void OneWire::resetStats() {
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+void OneWire::statTime(uint8_t op, uint32_t start) {
+	uint32_t elapsed = micros() - start;
+	OneWireOpStats &stats = mStats.ops[op];
+
+	stats.count++;
+	stats.totalMicros += elapsed;
+	if (elapsed > stats.maxMicros) {
+		stats.maxMicros = elapsed;
+	}
+}
+#endif
+
 /**
  * Helper functions to make dealing with I2C side easier
  */
 void OneWire::begin() {
-	Wire.beginTransmission(mAddress);
+	mWire->beginTransmission(mAddress);
 }
 
 
 uint8_t OneWire::end() {
-	return Wire.endTransmission();
+	uint8_t result = mWire->endTransmission();
+
+	ONEWIRE_STAT(i2cWrites);
+	if (result) {
+		ONEWIRE_STAT(i2cNacks);
+	}
+
+	return result;
 }
 
 
 void OneWire::writeByte(uint8_t data) {
-	Wire.write(data);
+	mWire->write(data);
 }
 
 
 uint8_t OneWire::readByte() {
-	Wire.requestFrom(mAddress, 1u);
-	return Wire.read();
+	ONEWIRE_STAT(i2cReads);
+	if (!mWire->requestFrom(mAddress, 1u)) {
+		mError |= DS2482_ERROR_I2C;
+	}
+	return mWire->read();
+}
+
+/**
+ * Issue a 1-Wire command in a single I2C transaction. Every 1-Wire command leaves the read pointer on the status
+ * register; if the command was not acknowledged, nothing is known about where the read pointer is.
+ */
+uint8_t OneWire::wireCommand(uint8_t command) {
+	begin();
+	writeByte(command);
+	return wireCommandSent(command);
+}
+
+
+uint8_t OneWire::wireCommand(uint8_t command, uint8_t param) {
+	begin();
+	writeByte(command);
+	writeByte(param);
+	return wireCommandSent(command);
+}
+
+
+/**
+ * The time, in microseconds, a 1-Wire command keeps the bridge busy at the current speed; tRSTL + tRSTH for a reset,
+ * and one tSLOT per time slot otherwise (DS2482-100 datasheet, 1-Wire timing tables). If the speed is not known, the
+ * (shorter) overdrive timings are used, so that the result is never longer than the real duration.
+ */
+uint16_t OneWire::commandDuration(uint8_t command) {
+	uint8_t overdrive = (mConfig == DS2482_CONFIG_UNKNOWN) || (mConfig & DS2482_CONFIG_1WS);
+	uint16_t slot = overdrive ? DS2482_TIME_SLOT_OVERDRIVE : DS2482_TIME_SLOT_STANDARD;
+
+	switch (command) {
+		case DS2482_COMMAND_RESETWIRE:
+			return overdrive ? DS2482_TIME_RESET_OVERDRIVE : DS2482_TIME_RESET_STANDARD;
+		case DS2482_COMMAND_WRITEBYTE:
+		case DS2482_COMMAND_READBYTE:
+			return 8 * slot;
+		case DS2482_COMMAND_TRIPLET:
+			return 3 * slot;
+		case DS2482_COMMAND_SINGLEBIT:
+			return slot;
+		default:
+			return 0;
+	}
+}
+
+
+uint16_t OneWire::busyTimeRemaining() {
+	uint32_t elapsed = micros() - mCommandStart;
+
+	return (elapsed < mCommandDuration) ? (uint16_t)(mCommandDuration - elapsed) : 0;
+}
+
+
+/**
+ * Completes the I2C transaction of a 1-Wire command, and keeps the read pointer and config register shadows in step
+ * with what the command does to the bridge.
+ */
+uint8_t OneWire::wireCommandSent(uint8_t command) {
+	uint8_t result = end();
+
+	if (result) {
+		/* Callers which may have sent the command early, and retry it, drop the flag again themselves */
+		mError |= DS2482_ERROR_I2C;
+
+		/* A bridge which is still busy does not acknowledge the command, and leaves the read pointer where it was */
+		if (result != 2 && result != 3) {
+			mReadPointer = DS2482_POINTER_UNKNOWN;
+		}
+		return result;
+	}
+
+	mReadPointer = DS2482_POINTER_STATUS;
+
+	mCommandStart = micros();
+	mCommandDuration = commandDuration(command);
+
+	if (mPullupActive) {
+		/* Starting any 1-Wire command ends the strong pullup, and the bridge clears SPU when it does */
+		mPullupActive = 0;
+		mPullupWindow = 0;
+		mConfig &= ~DS2482_CONFIG_SPU;
+	} else if ((mConfig != DS2482_CONFIG_UNKNOWN) && (mConfig & DS2482_CONFIG_SPU) &&
+			(command == DS2482_COMMAND_WRITEBYTE || command == DS2482_COMMAND_SINGLEBIT)) {
+		/* An armed SPU takes effect once this command's last time slot has completed */
+		mPullupActive = 1;
+	}
+
+	return result;
 }
 
 /**
@@ -78,8 +339,100 @@ uint8_t OneWire::checkPresence() {
  */
 void OneWire::deviceReset() {
 	begin();
-	write(DS2482_COMMAND_RESET);
-	end();
+	writeByte(DS2482_COMMAND_RESET);
+
+	/*
+	 * A device reset leaves the read pointer on the status register and clears the config register; a DS2482-800 also
+	 * comes out of it on channel 0 (a single-channel DS2482 simply has no other channel).
+	 */
+	if (end()) {
+		mError |= DS2482_ERROR_I2C;
+		mReadPointer = DS2482_POINTER_UNKNOWN;
+		mConfig = DS2482_CONFIG_UNKNOWN;
+		mChannel = DS2482_CHANNEL_UNKNOWN;
+	} else {
+		mReadPointer = DS2482_POINTER_STATUS;
+		mConfig = 0;
+		mChannel = 0;
+	}
+	mPullupActive = 0;
+	mPullupWindow = 0;
+	mLastRomValid = 0;
+
+	/* The reset has cleared the config register, so the bus profile has to be put back */
+	if (mConfig == 0 && (mProfile & ONEWIRE_PROFILE_CONFIG)) {
+		writeConfig(mProfile & ONEWIRE_PROFILE_CONFIG);
+	}
+}
+
+
+/**
+ * Changing the profile only writes the config bits it changes; the SPU bit is left alone, so an armed strong pullup
+ * stays armed.
+ */
+void OneWire::setBusProfile(uint8_t profile) {
+	uint8_t config = cachedConfig();
+	uint8_t wanted = (config & ~ONEWIRE_PROFILE_CONFIG) | (profile & ONEWIRE_PROFILE_CONFIG);
+
+	mProfile = profile;
+
+	if (wanted != config) {
+		writeConfig(wanted);
+	}
+}
+
+
+uint8_t OneWire::getBusProfile() {
+	return mProfile;
+}
+
+
+/**
+ * Select the active 1-Wire channel of a DS2482-800. The Channel Select command is only sent when the channel changes;
+ * the bridge confirms the selection with a channel-specific code, which is checked before the new channel is cached.
+ */
+uint8_t OneWire::selectChannel(uint8_t channel) {
+	/* Channel Select codes, and the codes read back from the channel selection register, for channels 0-7 */
+	static const uint8_t selectCodes[8] = { 0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87 };
+	static const uint8_t readbackCodes[8] = { 0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87 };
+
+	/* Range first, so that an invalid channel can never match a sentinel held in the cache */
+	if (channel > 7) {
+		mError |= DS2482_ERROR_CHANNEL;
+		return false;
+	}
+
+	if (channel == mChannel) {
+		return true;
+	}
+
+	/* The bridge does not accept a Channel Select while a 1-Wire command is still running */
+	waitOnBusy();
+
+	/* The last selected device is on the channel being left */
+	mLastRomValid = 0;
+
+	begin();
+	writeByte(DS2482_COMMAND_CHSL);
+	writeByte(selectCodes[channel]);
+
+	/* Channel Select leaves the read pointer on the channel selection register */
+	if (end()) {
+		mReadPointer = DS2482_POINTER_UNKNOWN;
+		mChannel = DS2482_CHANNEL_UNKNOWN;
+		mError |= DS2482_ERROR_CHANNEL;
+		return false;
+	}
+	mReadPointer = DS2482_POINTER_CHANNEL;
+
+	if (readByte() != readbackCodes[channel]) {
+		mChannel = DS2482_CHANNEL_UNKNOWN;
+		mError |= DS2482_ERROR_CHANNEL;
+		return false;
+	}
+
+	mChannel = channel;
+	return true;
 }
 
 
@@ -87,15 +440,23 @@ void OneWire::setReadPointer(uint8_t readPointer) {
 	begin();
 	writeByte(DS2482_COMMAND_SRP);
 	writeByte(readPointer);
-	end();
+
+	if (end()) {
+		mError |= DS2482_ERROR_I2C;
+		mReadPointer = DS2482_POINTER_UNKNOWN;
+	} else {
+		mReadPointer = readPointer;
+	}
 }
 
 
 /**
- * Read the status register
+ * Read the status register, only moving the read pointer when it is somewhere else
  */
 uint8_t OneWire::readStatus() {
-	setReadPointer(DS2482_POINTER_STATUS);
+	if (mReadPointer != DS2482_POINTER_STATUS) {
+		setReadPointer(DS2482_POINTER_STATUS);
+	}
 	return readByte();
 }
 
@@ -104,7 +465,9 @@ uint8_t OneWire::readStatus() {
  * Read the data register
  */
 uint8_t OneWire::readData() {
-	setReadPointer(DS2482_POINTER_DATA);
+	if (mReadPointer != DS2482_POINTER_DATA) {
+		setReadPointer(DS2482_POINTER_DATA);
+	}
 	return readByte();
 }
 
@@ -113,8 +476,22 @@ uint8_t OneWire::readData() {
  * Read the config register
  */
 uint8_t OneWire::readConfig() {
-	setReadPointer(DS2482_POINTER_CONFIG);
-	return readByte();
+	if (mReadPointer != DS2482_POINTER_CONFIG) {
+		setReadPointer(DS2482_POINTER_CONFIG);
+	}
+	mConfig = readByte();
+	return mConfig;
+}
+
+
+/**
+ * The config register as last written or read; only goes to the bridge when the shadow copy is not valid
+ */
+uint8_t OneWire::cachedConfig() {
+	if (mConfig == DS2482_CONFIG_UNKNOWN) {
+		readConfig();
+	}
+	return mConfig;
 }
 
 
@@ -136,7 +513,22 @@ uint8_t OneWire::readConfig() {
  * @brief Activates the strong pullup function for the following transaction.
  */
 void OneWire::setStrongPullup() {
-	writeConfig(readConfig() | DS2482_CONFIG_SPU);
+	/* An externally powered bus has no use for the strong pullup, and not arming it saves a config write */
+	if (mProfile & ONEWIRE_PROFILE_NO_SPU) {
+		return;
+	}
+
+	/*
+	 * A strong pullup that is still running from the previous command will end (and clear SPU) as soon as the next
+	 * command starts, so it has to be ended explicitly before SPU can be armed again for that next command.
+	 */
+	if (mPullupActive) {
+		clearStrongPullup();
+	}
+
+	if (!(cachedConfig() & DS2482_CONFIG_SPU)) {
+		writeConfig(mConfig | DS2482_CONFIG_SPU);
+	}
 }
 
 
@@ -146,7 +538,66 @@ void OneWire::setStrongPullup() {
  * @brief Manually clear the strong pullup bit in the DS2482 config register.
  */
 void OneWire::clearStrongPullup() {
-	writeConfig(readConfig() & !DS2482_CONFIG_SPU);
+	if (cachedConfig() & DS2482_CONFIG_SPU) {
+		writeConfig(mConfig & ~DS2482_CONFIG_SPU);
+	}
+}
+
+
+uint8_t OneWire::startStrongPullup(uint8_t data, uint32_t duration) {
+	waitOnBusy();
+	if (!wireWriteByteStart(data, 1)) {
+		mPullupWindow = 0;
+		return false;
+	}
+
+	/* The window starts with the byte itself, as the pullup only comes on once its time slots are done */
+	mPullupStart = mCommandStart;
+	mPullupWindow = mCommandDuration + duration;
+	if (!mPullupWindow) {
+		mPullupWindow = 1;
+	}
+
+	return true;
+}
+
+
+uint8_t OneWire::pollStrongPullup() {
+	if (!mPullupWindow) {
+		return false;
+	}
+
+	if (strongPullupRemaining()) {
+		return true;
+	}
+
+	depower();
+	return false;
+}
+
+
+uint32_t OneWire::strongPullupRemaining() {
+	uint32_t elapsed = micros() - mPullupStart;
+
+	if (!mPullupWindow || elapsed >= mPullupWindow) {
+		return 0;
+	}
+
+	return mPullupWindow - elapsed;
+}
+
+
+/**
+ * Sleeps until the last 1-Wire command must have completed, without any I2C traffic. The datasheet timings are
+ * padded by an eighth, so that the bridge's timing tolerance does not make the next command arrive too early.
+ */
+void OneWire::waitOnCommand() {
+	uint16_t remaining = busyTimeRemaining();
+
+	if (remaining) {
+		pause(remaining + (mCommandDuration >> 3));
+	}
+	mCommandDuration = 0;
 }
 
 
@@ -158,24 +609,39 @@ void OneWire::clearStrongPullup() {
  */
 uint8_t OneWire::waitOnBusy() {
 	uint8_t status;
+	uint32_t start;
+	ONEWIRE_STAT_TIMER(timer);
+
+	/* Don't bother reading the status register before the last command can possibly have completed */
+	uint16_t remaining = busyTimeRemaining();
+	if (remaining) {
+		pause(remaining);
+	}
+	mCommandDuration = 0;
 
-	/* Check register status every 20 microseconds */
-	for (int i = 1000; i > 0; i--) {
+	/* Then check the register status every mPollInterval microseconds */
+	mLastPollCount = 0;
+	start = micros();
+	for (;;) {
 		status = readStatus();
+		mLastPollCount++;
+		ONEWIRE_STAT(polls);
 
-		/* Break out of loop if the busy status bit clears up */
-		if (!(status & DS2482_STATUS_BUSY)) {
+		/* Break out of loop if the busy status bit clears up, or if it has been set for too long */
+		if (!(status & DS2482_STATUS_BUSY) || (micros() - start) >= ONEWIRE_BUSY_TIMEOUT) {
 			break;
 		}
 
-		/* Wait 20 microseconds before checking the status again... */
-		delayMicroseconds(20);
+		pause(mPollInterval);
 	}
+	mTotalPollCount += mLastPollCount;
 
 	/* It is likely an error has occurred if the busy status bit is still set */
 	if (status & DS2482_STATUS_BUSY) {
-		mError = DS2482_ERROR_TIMEOUT;
+		mError |= DS2482_ERROR_TIMEOUT;
+		ONEWIRE_STAT(timeouts);
 	}
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_WAIT, timer);
 
 	/* Return the status so we don't need to explicitly do it again */
 	return status;
@@ -193,7 +659,14 @@ void OneWire::writeConfig(uint8_t config) {
 	 * - Bytes 4-7: one's complement of bytes 0-3
 	 */
 	writeByte(config | (~config)<<4);
-	end();
+
+	/* Write Configuration leaves the read pointer on the config register */
+	mReadPointer = end() ? DS2482_POINTER_UNKNOWN : DS2482_POINTER_CONFIG;
+
+	/* Writing SPU as 0 ends a strong pullup that is still being driven */
+	if (!(config & DS2482_CONFIG_SPU)) {
+		mPullupActive = 0;
+	}
 
 	/*
 	 * Readback of the config register will return data in the following format:
@@ -201,22 +674,20 @@ void OneWire::writeConfig(uint8_t config) {
 	 * - Bytes 4-7: 0000b
 	 */
 	if (readByte() != config) {
-		mError = DS2482_ERROR_CONFIG;
+		mError |= DS2482_ERROR_CONFIG;
+		mConfig = DS2482_CONFIG_UNKNOWN;
+	} else {
+		mConfig = config;
 	}
 }
 
 
-/**
- * Generates a 1-Wire reset/presence-detect cycle on the 1-Wire line. Note that
- * a diagram of this process can be found at figure 4 of the official datasheet
- * for the DS2482-100.
- *
- * The state of the 1-Wire line is sampled at tSI and tMSP, and the result is
- * reported to the host processor through the status register bits 'PPD' & 'SD'.
- */
-uint8_t OneWire::wireReset() {
-	waitOnBusy();
+// ****************************************
+// Non-blocking primitives: each one starts a single 1-Wire command, and returns as soon as the bridge has accepted it.
+// The bridge must be idle when they are called.
+// ****************************************
 
+uint8_t OneWire::wireResetStart() {
 	/*
 	 * Ensure that the SPU (strong pullup) bit is cleared before execution, as
 	 * its use may result in 'PPD' containing invalid data, and/or device(s)
@@ -225,18 +696,72 @@ uint8_t OneWire::wireReset() {
 	 */
 	clearStrongPullup();
 
+	return !wireCommand(DS2482_COMMAND_RESETWIRE);
+}
+
+
+uint8_t OneWire::wireWriteByteStart(uint8_t data, uint8_t power) {
+	if (power) {
+		setStrongPullup();
+	}
+
+	return !wireCommand(DS2482_COMMAND_WRITEBYTE, data);
+}
+
+
+uint8_t OneWire::wireReadByteStart() {
+	return !wireCommand(DS2482_COMMAND_READBYTE);
+}
+
+
+uint8_t OneWire::wireWriteBitStart(uint8_t data, uint8_t power) {
+	if (power) {
+		setStrongPullup();
+	}
+
+	return !wireCommand(DS2482_COMMAND_SINGLEBIT, data ? 0x80 : 0x00);
+}
+
+// ****************************************
+// End non-blocking primitives
+// ****************************************
+
+
+/**
+ * Generates a 1-Wire reset/presence-detect cycle on the 1-Wire line. Note that
+ * a diagram of this process can be found at figure 4 of the official datasheet
+ * for the DS2482-100.
+ *
+ * The state of the 1-Wire line is sampled at tSI and tMSP, and the result is
+ * reported to the host processor through the status register bits 'PPD' & 'SD'.
+ */
+uint8_t OneWire::wireReset() {
+	ONEWIRE_STAT_TIMER(timer);
 	waitOnBusy();
 
-	begin();
-	writeByte(DS2482_COMMAND_RESETWIRE);
-	end();
+	wireResetStart();
 
 	uint8_t status = waitOnBusy();
 
 	if (status & DS2482_STATUS_SD) {
-		mError = DS2482_ERROR_SHORT;
+		mError |= DS2482_ERROR_SHORT;
+		ONEWIRE_STAT(shorts);
 	}
 
+	/*
+	 * Devices which were in overdrive and didn't answer an overdrive reset have most likely fallen back to standard
+	 * speed (e.g. they have been power cycled); go back to standard speed, so the next reset can find them again.
+	 */
+	if (!(status & DS2482_STATUS_PPD) && (mConfig != DS2482_CONFIG_UNKNOWN) && (mConfig & DS2482_CONFIG_1WS)) {
+		setOverdrive(0);
+	}
+
+	/* Without a presence pulse, the last selected device may have lost power, and with it its Resume flag */
+	if (!(status & DS2482_STATUS_PPD)) {
+		mLastRomValid = 0;
+	}
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_RESET, timer);
+
 	return (status & DS2482_STATUS_PPD) ? true : false;
 }
 
@@ -251,67 +776,121 @@ uint8_t OneWire::wireReset() {
  * @param[in]	power	An optional, unsigned byte value, activates the SPU function when containing a value >= 1.
  */
 void OneWire::wireWriteByte(uint8_t data, uint8_t power) {
+	ONEWIRE_STAT_TIMER(timer);
 	waitOnBusy();
+	wireWriteByteStart(data, power);
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_WRITE, timer);
+}
 
-	if (power) {
-		setStrongPullup();
+/**
+ * Write multiple bytes to the 1-Wire bus. Each byte goes out as its own 1-Wire Write Byte command, in the smallest I2C
+ * transaction the DS2482 accepts. Between two bytes, the status register is not read: waitOnCommand() sleeps until the
+ * previous byte must have gone out, with a margin of an eighth for the bridge's timing tolerance, and the next Write
+ * Byte is sent straight away. That is safe because the DS2482 does not acknowledge a 1-Wire command while the 1-Wire
+ * line is still busy, and does not act on it either; a NACK therefore means only that the timing was off, and the byte
+ * is sent again once waitOnBusy() has seen the bridge go idle. A slow or clock-stretched I2C bus only makes the next
+ * command arrive later, so the NACK path is only taken if the bridge's own slots run longer than the margin allows.
+ * Each byte normally costs a single I2C transaction instead of the two a status poll takes.
+ *
+ * When 'power' is set, the strong pullup is only armed for the last byte; that is the byte (e.g. Convert T or Copy
+ * Scratchpad) after which a parasitically-powered device needs the extra current. Arming it writes the config
+ * register, so that byte is preceded by a status poll, to be sure the bridge takes the config write.
+ */
+void OneWire::wireWriteBytes(const uint8_t *dbuf, uint16_t count, uint8_t power) {
+	ONEWIRE_STAT_TIMER(timer);
+
+	for (uint16_t i = 0; i < count; i++) {
+		uint8_t last = power && (i == count - 1);
+
+		if (last) {
+			waitOnBusy();
+		} else {
+			waitOnCommand();
+		}
+
+		uint8_t error = mError;
+
+		/* A NACK means the bridge was still busy and ignored the byte: wait until it is idle, and send it again */
+		if (!wireWriteByteStart(dbuf[i], last)) {
+			mError = error;
+			ONEWIRE_STAT(retries);
+			waitOnBusy();
+			wireWriteByteStart(dbuf[i], last);
+		}
 	}
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_WRITE, timer);
+}
 
-	begin();
-	writeByte(DS2482_COMMAND_WRITEBYTE);
-	writeByte(data);
-	end();
+
+uint8_t OneWire::wireReadBytes(uint8_t *buf, uint16_t count, uint8_t crc) {
+	readBytes(buf, count, &crc, 0);
+	return crc;
 }
 
+
+uint16_t OneWire::wireReadBytesCrc16(uint8_t *buf, uint16_t count, uint16_t crc) {
+	readBytes(buf, count, 0, &crc);
+	return crc;
+}
+
+
 /**
- * Write multiple bytes to the 1-Wire bus.
+ * The same Read Byte, status read and data read sequence as wireReadBytes(), without the CRC
  */
-void OneWire::wireWriteBytes(const uint8_t *dbuf, uint16_t count, uint8_t power) {
+void OneWire::wireStreamBytes(uint8_t *buf, uint16_t count) {
+	readBytes(buf, count, 0, 0);
+}
+
+
+/**
+ * Reads a run of bytes, folding each one into the CRC8 and/or CRC16 (whichever is given) while the bridge is busy
+ * reading the next one.
+ */
+void OneWire::readBytes(uint8_t *buf, uint16_t count, uint8_t *crc8, uint16_t *crc16) {
+	ONEWIRE_STAT_TIMER(timer);
 	waitOnBusy();
 
-	/* begin the I2C transaction */
-	begin();
+	for (uint16_t i = 0; i <= count; i++) {
+		/* The bridge is known to be idle here, so the next Read Byte can go out straight away */
+		if (i < count) {
+			wireReadByteStart();
+		}
 
-	/* write out all of our data in one continuous I2C transaction */
-	for (uint16_t i = 0; i < count; i++) {
-		/* set the strong pullup bit before each write, if necessary */
-		if (power) {
-			uint8_t cfgreg = 0x00;
-			Wire.write(DS2482_COMMAND_SRP);
-			Wire.write(DS2482_POINTER_CONFIG);
-			Wire.requestFrom(mAddress, 1u);
-			cfgreg = Wire.read();
-			cfgreg = (cfgreg | DS2482_CONFIG_SPU);
-			Wire.write(DS2482_COMMAND_WRITECONFIG);
-			Wire.write(cfgreg | (~cfgreg)<<4);
-			Wire.requestFrom(mAddress, 1u);
-			if (Wire.read() != cfgreg) {
-				mError = DS2482_ERROR_CONFIG;
+		/* Fold the previous byte into the CRC while this one is on the wire */
+		if (i) {
+			if (crc8) {
+				*crc8 = crc8Update(*crc8, buf[i - 1]);
+			}
+			if (crc16) {
+				*crc16 = crc16Update(*crc16, buf[i - 1]);
 			}
 		}
 
-		/* write the current byte */
-		Wire.write(DS2482_COMMAND_WRITEBYTE);
-		Wire.write(dbuf[i]);
-	}
+		if (i < count) {
+			/* The Read Byte command parked the read pointer on the status register; poll it in place */
+			waitOnBusy();
 
-	/* end the I2C transaction */
-	end();
+			buf[i] = readData();
+		}
+	}
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_READ, timer);
 }
 
 /**
  * Generates eight read-data time slots on the 1-Wire line and stores result in the Read Data Register.
  */
 uint8_t OneWire::wireReadByte() {
+	ONEWIRE_STAT_TIMER(timer);
 	waitOnBusy();
 
-	begin();
-	writeByte(DS2482_COMMAND_READBYTE);
-	end();
+	wireReadByteStart();
 
 	waitOnBusy();
 
-	return readData();
+	uint8_t data = readData();
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_READ, timer);
+
+	return data;
 }
 
 /**
@@ -328,50 +907,262 @@ uint8_t OneWire::wireReadByte() {
  * @param[in]	power	An optional, unsigned byte value, activates the SPU function when containing a value >= 1.
  */
 void OneWire::wireWriteBit(uint8_t data, uint8_t power) {
+	ONEWIRE_STAT_TIMER(timer);
 	waitOnBusy();
-	if (power)
-		setStrongPullup();
-	begin();
-	writeByte(DS2482_COMMAND_SINGLEBIT);
-	writeByte(data ? 0x80 : 0x00);
-	end();
+	wireWriteBitStart(data, power);
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_BIT, timer);
 }
 
 // As wireWriteBit
 uint8_t OneWire::wireReadBit() {
-	wireWriteBit(1);
+	ONEWIRE_STAT_TIMER(timer);
+	waitOnBusy();
+	wireWriteBitStart(1);
 	uint8_t status = waitOnBusy();
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_BIT, timer);
 	return status & DS2482_STATUS_SBR ? 1 : 0;
 }
 
 // 1-Wire skip
 void OneWire::wireSkip() {
+	mLastRomValid = 0;
 	wireWriteByte(WIRE_COMMAND_SKIP);
 }
 
 void OneWire::wireSelect(const uint8_t rom[8]) {
-	wireWriteByte(WIRE_COMMAND_SELECT);
-	for (int i=0;i<8;i++)
-		wireWriteByte(rom[i]);
+	uint8_t buf[9];
+
+	buf[0] = WIRE_COMMAND_SELECT;
+	for (uint8_t i = 0; i < 8; i++) {
+		buf[i + 1] = rom[i];
+	}
+
+	wireWriteBytes(buf, sizeof(buf));
+
+	for (uint8_t i = 0; i < 8; i++) {
+		mLastRom[i] = rom[i];
+	}
+	mLastRomValid = 1;
+}
+
+
+void OneWire::wireResume() {
+	wireWriteByte(WIRE_COMMAND_RESUME);
+}
+
+
+uint8_t OneWire::wireResumeSelect(const uint8_t rom[8]) {
+	uint8_t i = 0;
+
+	while (mLastRomValid && i < 8 && mLastRom[i] == rom[i]) {
+		i++;
+	}
+
+	if (i == 8) {
+		wireResume();
+		return 1;
+	}
+
+	wireSelect(rom);
+	return 0;
+}
+
+
+void OneWire::clearLastSelected() {
+	mLastRomValid = 0;
+}
+
+// 1-Wire overdrive skip: the command goes out at standard speed, everything after it at overdrive speed
+void OneWire::wireOverdriveSkip() {
+	mLastRomValid = 0;
+	wireWriteByte(WIRE_COMMAND_OVERDRIVE_SKIP);
+	setOverdrive(1);
+}
+
+// 1-Wire overdrive select: only the command goes out at standard speed, the ROM already at overdrive speed
+void OneWire::wireOverdriveSelect(const uint8_t rom[8]) {
+	wireWriteByte(WIRE_COMMAND_OVERDRIVE_SELECT);
+	setOverdrive(1);
+	wireWriteBytes(rom, 8);
+
+	for (uint8_t i = 0; i < 8; i++) {
+		mLastRom[i] = rom[i];
+	}
+	mLastRomValid = 1;
+}
+
+
+void OneWire::setOverdrive(uint8_t overdrive) {
+	uint8_t config = cachedConfig();
+	uint8_t speed = overdrive ? (config | DS2482_CONFIG_1WS) : (config & ~DS2482_CONFIG_1WS);
+
+	if (speed != config) {
+		writeConfig(speed);
+	}
+}
+
+
+uint8_t OneWire::isOverdrive() {
+	return (cachedConfig() & DS2482_CONFIG_1WS) ? true : false;
 }
 
 //  1-Wire reset seatch algorithm
 void OneWire::wireResetSearch() {
-	searchLastDiscrepancy = 0;
-	searchLastDeviceFlag = 0;
+	wireResetSearch(mSearch);
+}
+
+
+void OneWire::wireResetSearch(OneWireSearchState &state) {
+	state.searchLastDiscrepancy = 0;
+	state.searchLastDeviceFlag = 0;
+	state.searchFamily = 0;
 
 	for (int i = 0; i < 8; i++) 	{
-		searchAddress[i] = 0;
+		state.searchAddress[i] = 0;
 	}
 
 }
 
+
+void OneWire::wireTargetSearch(uint8_t family) {
+	wireTargetSearch(family, mSearch);
+}
+
+
+// Seed the search with the family code, and a last discrepancy past the family byte, so that the first pass follows
+// the family's branch and takes the 1 branch at any discrepancy after it
+void OneWire::wireTargetSearch(uint8_t family, OneWireSearchState &state) {
+	wireResetSearch(state);
+
+	state.searchAddress[0] = family;
+	state.searchLastDiscrepancy = 64;
+	state.searchFamily = family;
+}
+
 // Perform a search of the 1-Wire bus
 uint8_t OneWire::wireSearch(uint8_t *address) {
+	return wireSearch(address, mSearch);
+}
+
+
+uint8_t OneWire::wireSearch(uint8_t *address, OneWireSearchState &state) {
+	ONEWIRE_STAT_TIMER(timer);
+	uint8_t found = searchRom(WIRE_COMMAND_SEARCH, address, state);
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_SEARCH, timer);
+
+	return found;
+}
+
+
+uint8_t OneWire::wireAlarmSearch(uint8_t *address) {
+	return wireAlarmSearch(address, mSearch);
+}
+
+
+uint8_t OneWire::wireAlarmSearch(uint8_t *address, OneWireSearchState &state) {
+	ONEWIRE_STAT_TIMER(timer);
+	uint8_t found = searchRom(WIRE_COMMAND_ALARM_SEARCH, address, state);
+	ONEWIRE_STAT_TIME(ONEWIRE_STAT_SEARCH, timer);
+
+	return found;
+}
+
+
+uint8_t OneWire::searchAll(uint8_t (*out)[8], uint8_t maxDevices, OneWireSearchReport *report) {
+	OneWireLock guard(*this);
+	OneWireSearchState state;
+	OneWireSearchState saved;
+	uint8_t rom[8];
+	uint8_t found = 0;
+	uint8_t attempts = 0;
+	uint8_t crcErrors = 0;
+	uint8_t retries = 0;
+	uint16_t passes = 0;
+	uint32_t start = micros();
+	uint32_t polls = mTotalPollCount;
+#if ONEWIRE_ENABLE_STATS
+	uint32_t transactions = mStats.i2cWrites + mStats.i2cReads;
+#endif
+
+	wireResetSearch(state);
+
+	while (found < maxDevices && !state.searchLastDeviceFlag) {
+		saved = state;
+		passes++;
+
+		uint8_t ok = wireSearch(rom, state);
+		uint8_t badCrc = ok && crc8(rom, 7) != rom[7];
+
+		if (ok && !badCrc) {
+			for (uint8_t i = 0; i < 8; i++) {
+				out[found][i] = rom[i];
+			}
+			found++;
+			attempts = 0;
+			continue;
+		}
+
+		if (badCrc) {
+			crcErrors++;
+			noteCrcError();
+		}
+
+		/* The pass failed or returned a ROM which cannot be trusted; run it again from the same branch point */
+		if (attempts++ >= ONEWIRE_SEARCH_RETRIES) {
+			state.searchLastDeviceFlag = 0;
+			break;
+		}
+		retries++;
+		state = saved;
+	}
+
+	if (report) {
+		report->devices = found;
+		report->complete = state.searchLastDeviceFlag;
+		report->crcErrors = crcErrors;
+		report->retries = retries;
+		report->passes = passes;
+		report->polls = mTotalPollCount - polls;
+#if ONEWIRE_ENABLE_STATS
+		report->transactions = mStats.i2cWrites + mStats.i2cReads - transactions;
+#else
+		report->transactions = 0;
+#endif
+		report->micros = micros() - start;
+	}
+
+	return found;
+}
+
+
+/**
+ * Runs one triplet, and returns the status register it left behind. The bridge must be idle when this is called; the
+ * search keeps it that way, as each triplet's result is only known once the bridge has finished with it, so no status
+ * read is needed before the next one. The triplet leaves the read pointer on the status register, so waiting for it is
+ * a plain read, without setting the read pointer first.
+ */
+uint8_t OneWire::wireTriplet(uint8_t direction) {
+	uint8_t error = mError;
+
+	if (wireCommand(DS2482_COMMAND_TRIPLET, direction ? 0x80 : 0x00)) {
+		/* Not acknowledged; the bridge was busy after all, so wait for it properly and try again */
+		mError = error;
+		ONEWIRE_STAT(retries);
+		waitOnBusy();
+		wireCommand(DS2482_COMMAND_TRIPLET, direction ? 0x80 : 0x00);
+	}
+
+	return waitOnBusy();
+}
+
+
+// The search algorithm shared by the normal and alarm searches, which only differ in their ROM command
+uint8_t OneWire::searchRom(uint8_t command, uint8_t *address, OneWireSearchState &state) {
+	OneWireLock guard(*this);
 	uint8_t direction;
 	uint8_t last_zero=0;
 
-	if (searchLastDeviceFlag) {
+	if (state.searchLastDeviceFlag) {
 		return 0;
 	}
 
@@ -379,27 +1170,25 @@ uint8_t OneWire::wireSearch(uint8_t *address) {
 		return 0;
 	}
 
-	waitOnBusy();
+	/* A search deselects the last selected device */
+	mLastRomValid = 0;
 
-	wireWriteByte(WIRE_COMMAND_SEARCH);
+	/* wireReset() has already waited for the bridge, so the ROM command can go out straight away */
+	wireWriteByteStart(command);
+	waitOnBusy();
 
 	for (uint8_t i = 0; i < 64; i++) {
 		int searchByte = i / 8;
 		int searchBit = 1 << i % 8;
 
-		if (i < searchLastDiscrepancy) {
-			direction = searchAddress[searchByte] & searchBit;
+		/* Bit positions are counted from 1, so that a last discrepancy of 0 can mean "none" */
+		if (i + 1 < state.searchLastDiscrepancy) {
+			direction = state.searchAddress[searchByte] & searchBit;
 		} else {
-			direction = i == searchLastDiscrepancy;
+			direction = i + 1 == state.searchLastDiscrepancy;
 		}
 
-		waitOnBusy();
-		begin();
-		writeByte(DS2482_COMMAND_TRIPLET);
-		writeByte(direction ? 0x80 : 0x00);
-		end();
-
-		uint8_t status = waitOnBusy();
+		uint8_t status = wireTriplet(direction);
 
 		uint8_t id = status & DS2482_STATUS_SBR;
 		uint8_t comp_id = status & DS2482_STATUS_TSB;
@@ -409,25 +1198,60 @@ uint8_t OneWire::wireSearch(uint8_t *address) {
 			return 0;
 		} else {
 			if (!id && !comp_id && !direction) {
-				last_zero = i;
+				last_zero = i + 1;
 			}
 		}
 
 		if (direction) {
-			searchAddress[searchByte] |= searchBit;
+			state.searchAddress[searchByte] |= searchBit;
 		} else {
-			searchAddress[searchByte] &= ~searchBit;
+			state.searchAddress[searchByte] &= ~searchBit;
+		}
+
+		/* A targeted search which has left its family's branch has no more devices to find */
+		if (i == 7 && state.searchFamily && state.searchAddress[0] != state.searchFamily) {
+			state.searchLastDeviceFlag = 1;
+			return 0;
 		}
 	}
 
-	searchLastDiscrepancy = last_zero;
+	state.searchLastDiscrepancy = last_zero;
 
-	if (!last_zero) {
-		searchLastDeviceFlag = 1;
+	/* The next pass would branch off within the family code, so a targeted search is done as well */
+	if (!last_zero || (state.searchFamily && last_zero <= 8)) {
+		state.searchLastDeviceFlag = 1;
 	}
 
 	for (uint8_t i = 0; i < 8; i++) {
-		address[i] = searchAddress[i];
+		address[i] = state.searchAddress[i];
+	}
+
+	return 1;
+}
+
+// Verify that a single device is present, following its ROM through a search pass
+uint8_t OneWire::wireVerify(const uint8_t rom[8]) {
+	OneWireLock guard(*this);
+
+	if (!wireReset()) {
+		return 0;
+	}
+
+	mLastRomValid = 0;
+	wireWriteByteStart(WIRE_COMMAND_SEARCH);
+	waitOnBusy();
+
+	for (uint8_t i = 0; i < 64; i++) {
+		uint8_t bit = (rom[i / 8] >> (i % 8)) & 0x01;
+		uint8_t status = wireTriplet(bit);
+
+		/* No device answered at all, or the bridge had to take the other branch: the ROM is not on the bus */
+		if ((status & DS2482_STATUS_SBR) && (status & DS2482_STATUS_TSB)) {
+			return 0;
+		}
+		if (((status & DS2482_STATUS_DIR) ? 1 : 0) != bit) {
+			return 0;
+		}
 	}
 
 	return 1;
@@ -498,45 +1322,171 @@ static const uint8_t dscrc_table[] = {
  * compared to all those delayMicrosecond() calls.  But I got
  * confused, so I use this table from the examples.)
  */
-uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len) {
-	uint8_t crc = 0;
-	
-	while (len--) {
+uint8_t OneWire::crc8Update(uint8_t crc, uint8_t data) {
 #ifdef PLATFORM_HAS_PROGMEM_AVAILABLE
-		crc = *(pgm_read_byte(dscrc_table + (crc ^ *addr++)));
+	return pgm_read_byte(dscrc_table + (crc ^ data));
 #else
-		crc = *(dscrc_table + (crc ^ *addr++));
+	return dscrc_table[crc ^ data];
 #endif
-	}
+}
 
-	return crc;
+#elif (ONEWIRE_USE_CRC8_TABLE == 2)
+/**
+ * \var dscrc_nibble_table	The CRC8 table, split by nibble: as the CRC is linear, the table entry for a byte is the
+ *							entry for its low nibble (the first 16 entries) XORed with the entry for its high nibble
+ *							(the last 16 entries).
+ */
+static const uint8_t dscrc_nibble_table[]
+#ifdef PLATFORM_HAS_PROGMEM_AVAILABLE
+		PROGMEM
+#endif
+		= {
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74
+};
+
+
+// Compute a Dallas Semiconductor 8 bit CRC with two nibble lookups per byte.
+uint8_t OneWire::crc8Update(uint8_t crc, uint8_t data) {
+	crc ^= data;
+
+#ifdef PLATFORM_HAS_PROGMEM_AVAILABLE
+	return pgm_read_byte(dscrc_nibble_table + (crc & 0x0F)) ^ pgm_read_byte(dscrc_nibble_table + 16 + (crc >> 4));
+#else
+	return dscrc_nibble_table[crc & 0x0F] ^ dscrc_nibble_table[16 + (crc >> 4)];
+#endif
 }
 
-#elif (ONEWIRE_USE_CRC8_TABLE == 0) || !defined(ONEWIRE_USE_CRC8_TABLE)
+#else
 
 // Compute a Dallas Semiconductor 8 bit CRC directly.
 // this is much slower, but much smaller, than the lookup table.
 //
+uint8_t OneWire::crc8Update(uint8_t crc, uint8_t data) {
+#if defined(__AVR__)
+	return _crc_ibutton_update(crc, data);
+#else
+	for (uint8_t i = 8; i; i--) {
+		uint8_t mix = (crc ^ data) & 0x01;
+		crc >>= 1;
+
+		if (mix) {
+			crc ^= 0x8C;
+		}
+
+		data >>= 1;
+	}
+
+	return crc;
+#endif
+}
+#endif	/* ONEWIRE_USE_CRC8_TABLE */
+
+
 uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len) {
 	uint8_t crc = 0;
 
 	while (len--) {
-		uint8_t inbyte = *addr++;
-		for (uint8_t i = 8; i; i--) {
-			uint8_t mix = (crc ^ inbyte) & 0x01;
-			crc >>= 1;
+		crc = crc8Update(crc, *addr++);
+	}
 
-			if (mix) {
-				crc ^= 0x8C;
-			}
+	return crc;
+}
 
-			inbyte >>= 1;
-		}
+
+#if (ONEWIRE_USE_CRC16_TABLE == 1)
+/**
+ * \var dscrc16_table	A pre-computed table for the Dallas CRC16 (reflected polynomial 0xA001).
+ */
+static const uint16_t dscrc16_table[]
+#ifdef PLATFORM_HAS_PROGMEM_AVAILABLE
+		PROGMEM
+#endif
+		= {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+
+uint16_t OneWire::crc16Update(uint16_t crc, uint8_t data) {
+#ifdef PLATFORM_HAS_PROGMEM_AVAILABLE
+	return (crc >> 8) ^ pgm_read_word(dscrc16_table + ((crc ^ data) & 0xFF));
+#else
+	return (crc >> 8) ^ dscrc16_table[(crc ^ data) & 0xFF];
+#endif
+}
+
+#else
+
+// Compute a Dallas Semiconductor 16 bit CRC directly, from the parity of the byte being shifted in.
+uint16_t OneWire::crc16Update(uint16_t crc, uint8_t data) {
+#if defined(__AVR__)
+	return _crc16_update(crc, data);
+#else
+	static const uint8_t oddparity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
+
+	uint16_t cdata = (data ^ crc) & 0xFF;
+	crc >>= 8;
+
+	if (oddparity[cdata & 0x0F] ^ oddparity[cdata >> 4]) {
+		crc ^= 0xC001;
+	}
+
+	cdata <<= 6;
+	crc ^= cdata;
+	cdata <<= 1;
+	crc ^= cdata;
+
+	return crc;
+#endif
+}
+#endif	/* ONEWIRE_USE_CRC16_TABLE */
+
+
+uint16_t OneWire::crc16(const uint8_t *input, uint16_t len, uint16_t crc) {
+	while (len--) {
+		crc = crc16Update(crc, *input++);
 	}
 
 	return crc;
 }
-#endif	/* ONEWIRE_USE_CRC8_TABLE */
+
+
+uint8_t OneWire::check_crc16(const uint8_t *input, uint16_t len, const uint8_t *inverted_crc, uint16_t crc) {
+	crc = ~crc16(input, len, crc);
+
+	return (crc & 0xFF) == inverted_crc[0] && (crc >> 8) == inverted_crc[1];
+}
 
 // ****************************************
 // These are here to mirror the functions in the original OneWire
@@ -548,8 +1498,12 @@ void OneWire::reset_search() {
 	wireResetSearch();
 }
 
-uint8_t OneWire::search(uint8_t *newAddr) {
-	return wireSearch(newAddr);
+void OneWire::target_search(uint8_t family_code) {
+	wireTargetSearch(family_code);
+}
+
+uint8_t OneWire::search(uint8_t *newAddr, uint8_t search_mode) {
+	return search_mode ? wireSearch(newAddr) : wireAlarmSearch(newAddr);
 }
 
 // Perform a 1-Wire reset cycle. Returns 1 if a device responds
@@ -559,6 +1513,12 @@ uint8_t OneWire::reset(void) {
 	return wireReset();
 }
 
+// Release the strong pullup; the config register is only written if the shadow shows SPU still set
+void OneWire::depower(void) {
+	mPullupWindow = 0;
+	clearStrongPullup();
+}
+
 // Issue a 1-Wire rom select command, you do the reset first.
 void OneWire::select(const uint8_t rom[8]) {
 	wireSelect(rom);
@@ -575,11 +1535,21 @@ void OneWire::write(uint8_t v, uint8_t power) {
 }
 
 
+void OneWire::write_bytes(const uint8_t *buf, uint16_t count, uint8_t power) {
+	wireWriteBytes(buf, count, power);
+}
+
+
 uint8_t OneWire::read(void) {
 	return wireReadByte();
 }
 
 
+void OneWire::read_bytes(uint8_t *buf, uint16_t count) {
+	wireReadBytes(buf, count);
+}
+
+
 uint8_t OneWire::read_bit(void) {
 	return wireReadBit();
 }
@@ -35,15 +35,76 @@
 /**
  * \def ONEWIRE_USE_CRC8_TABLE	Defines the behavior of CRC calculation. The behavior is dependent on the value defined;
  *								if the value is defined as 1, use the pre-computed, table-based CRC calculation. If the
- *								defined value is 0, or if the value is not defined at all, compute the CRC values in an
- *								on-demand fashion. Other values will result in an error.
+ *								value is defined as 2, use a pair of 16-entry tables, one lookup per nibble. If the
+ *								defined value is 0, compute the CRC values in an on-demand fashion. Other values will
+ *								result in an error.
  *
  * \note	Pre-computed, table-based CRC calculations result in faster calculations, at the expense of consuming more
- *			of the available flash memory.
+ *			of the available flash memory (256 bytes).
+ *			The nibble tables only take 32 bytes, and are still several times faster than the on-demand computation;
+ *			they are a good fit for flash-constrained parts such as the ATtiny series.
  *			Real-time computation of CRC values results in a smaller code size, uses less flash memory, however, on many
  *			devices, computation of CRC values is significantly slower than calculation via the lookup table method.
+ *			On AVR, it uses the optimized \c _crc_ibutton_update() of avr-libc.
  */
+#ifndef ONEWIRE_USE_CRC8_TABLE
 #define ONEWIRE_USE_CRC8_TABLE 			1
+#endif
+
+#if (ONEWIRE_USE_CRC8_TABLE < 0) || (ONEWIRE_USE_CRC8_TABLE > 2)
+#error "ONEWIRE_USE_CRC8_TABLE must be 0 (on-demand), 1 (256-byte table) or 2 (nibble tables)"
+#endif
+
+/**
+ * \def ONEWIRE_USE_CRC16_TABLE	Defines the behavior of CRC16 calculation, as used by the memory and PIO devices
+ *								(DS2408, DS2431, DS28EC20...). If the value is defined as 1, use a pre-computed,
+ *								512-byte table; if it is defined as 0, compute the CRC16 with the parity-based method of
+ *								the original OneWire library (or the optimized \c _crc16_update() of avr-libc on AVR).
+ */
+#ifndef ONEWIRE_USE_CRC16_TABLE
+#define ONEWIRE_USE_CRC16_TABLE			0
+#endif
+
+
+/**
+ * \def ONEWIRE_I2C_TRANSPORT	The class of the I²C bus object the bridges are driven through; \c TwoWire by default. A
+ *								different Wire-compatible driver (e.g. \c i2c_t3 on Teensy, or a DMA-driven one) can be
+ *								used by defining this, and ONEWIRE_I2C_INCLUDE as the header declaring it, for the whole
+ *								build; that header must also provide a default bus object named \c Wire. The bus object
+ *								is passed to the constructor and called through a pointer, as with \c Wire itself; the
+ *								class is not a template parameter.
+ *
+ * The header is included here rather than the class being forward-declared, since some cores (ArduinoCore-mbed, and
+ * those built on ArduinoCore-API) make \c TwoWire a typedef or an alias into a namespace.
+ */
+#ifdef ONEWIRE_I2C_INCLUDE
+#include ONEWIRE_I2C_INCLUDE
+#else
+#include <Wire.h>
+#endif
+
+#ifndef ONEWIRE_I2C_TRANSPORT
+#define ONEWIRE_I2C_TRANSPORT			TwoWire
+#endif
+
+typedef ONEWIRE_I2C_TRANSPORT OneWireI2C;
+
+
+/**
+ * \def ONEWIRE_POLL_INTERVAL	The default interval, in microseconds, between two reads of the status register while
+ *								waiting for the busy bit to clear. May be changed at runtime with setPollInterval().
+ */
+#ifndef ONEWIRE_POLL_INTERVAL
+#define ONEWIRE_POLL_INTERVAL			20
+#endif
+
+/**
+ * \def ONEWIRE_BUSY_TIMEOUT	How long, in microseconds, waitOnBusy() waits for the busy bit to clear before it gives
+ *								up and flags DS2482_ERROR_TIMEOUT.
+ */
+#ifndef ONEWIRE_BUSY_TIMEOUT
+#define ONEWIRE_BUSY_TIMEOUT			20000
+#endif
 
 
 /**
@@ -56,6 +117,8 @@
 #define DS2482_POINTER_STATUS		0xF0	/*! */
 #define DS2482_POINTER_DATA			0xE1	/*! */
 #define DS2482_POINTER_CONFIG		0xC3	/*! */
+#define DS2482_POINTER_CHANNEL		0xD2	/*! The channel selection register (DS2482-800 only) */
+#define DS2482_POINTER_UNKNOWN		0x00	/*! Not a register; marks the read pointer position as unknown */
 
 #define DS2482_COMMAND_WRITECONFIG	0xD2	/*! */
 #define DS2482_COMMAND_RESETWIRE	0xB4	/*! */
@@ -63,10 +126,15 @@
 #define DS2482_COMMAND_READBYTE		0x96	/*! */
 #define DS2482_COMMAND_SINGLEBIT	0x87	/*! */
 #define DS2482_COMMAND_TRIPLET		0x78	/*! */
+#define DS2482_COMMAND_CHSL			0xC3	/*! The command to select the active 1-Wire channel (DS2482-800 only). */
 
 #define WIRE_COMMAND_SKIP			0xCC	/*! The 1-Wire protocol command to issue a "SKIP_ROM" */
 #define WIRE_COMMAND_SELECT			0x55	/*! The 1-Wire protocol command to issue a "SELECT_ROM" */
 #define WIRE_COMMAND_SEARCH			0xF0	/*! The 1-Wire protocol command to issue a "SEARCH_ROM" */
+#define WIRE_COMMAND_ALARM_SEARCH		0xEC	/*! The 1-Wire protocol command to issue an "ALARM_SEARCH" */
+#define WIRE_COMMAND_RESUME			0xA5	/*! The 1-Wire protocol command to issue a "RESUME" */
+#define WIRE_COMMAND_OVERDRIVE_SKIP		0x3C	/*! The 1-Wire protocol command to issue an "OVERDRIVE_SKIP_ROM" */
+#define WIRE_COMMAND_OVERDRIVE_SELECT	0x69	/*! The 1-Wire protocol command to issue an "OVERDRIVE_MATCH_ROM" */
 
 
 #define DS2482_STATUS_BUSY			(1<<0)	/*! */
@@ -81,10 +149,151 @@
 #define DS2482_CONFIG_APU			(1<<0)	/*! */
 #define DS2482_CONFIG_SPU			(1<<2)	/*! */
 #define DS2482_CONFIG_1WS			(1<<3)	/*! */
+#define DS2482_CONFIG_UNKNOWN		0xFF	/*! Not a config value; marks the config register shadow as invalid */
+
+#define ONEWIRE_PROFILE_APU			DS2482_CONFIG_APU	/*! Bus profile: drive the active pullup on rising edges */
+#define ONEWIRE_PROFILE_OVERDRIVE	DS2482_CONFIG_1WS	/*! Bus profile: run the bridge at overdrive speed */
+#define ONEWIRE_PROFILE_NO_SPU		(1<<4)	/*! Bus profile: the bus is externally powered; ignore strong pullup requests */
+#define ONEWIRE_PROFILE_CONFIG		(ONEWIRE_PROFILE_APU | ONEWIRE_PROFILE_OVERDRIVE)	/*! Profile bits which go to the config register */
+
+#define ONEWIRE_PROFILE_SHORT		0						/*! Bus profile for a short bus, with few devices */
+#define ONEWIRE_PROFILE_LONG		ONEWIRE_PROFILE_APU		/*! Bus profile for long lines and star topologies */
+
+/**
+ * \def ONEWIRE_BUS_PROFILE	The bus profile a new instance starts out with; see setBusProfile().
+ */
+#ifndef ONEWIRE_BUS_PROFILE
+#define ONEWIRE_BUS_PROFILE			ONEWIRE_PROFILE_SHORT
+#endif
+
+#define DS2482_TIME_RESET_STANDARD		1144	/*! tRSTL + tRSTH at standard speed, in microseconds */
+#define DS2482_TIME_RESET_OVERDRIVE		144		/*! tRSTL + tRSTH at overdrive speed, in microseconds */
+#define DS2482_TIME_SLOT_STANDARD		69		/*! tSLOT at standard speed, in microseconds */
+#define DS2482_TIME_SLOT_OVERDRIVE		10		/*! tSLOT at overdrive speed (10.5µs), rounded down, in microseconds */
 
 #define DS2482_ERROR_TIMEOUT		(1<<0)	/*! */
 #define DS2482_ERROR_SHORT			(1<<1)	/*! */
 #define DS2482_ERROR_CONFIG			(1<<2)	/*! */
+#define DS2482_ERROR_CHANNEL		(1<<3)	/*! A Channel Select was refused, or was not confirmed by the bridge */
+#define DS2482_ERROR_I2C			(1<<4)	/*! The bridge did not acknowledge an I2C transaction, or returned no data */
+
+#define DS2482_CHANNEL_UNKNOWN		0xFF	/*! Not a channel; marks the active channel as unknown */
+
+
+/**
+ * \struct OneWireSearchState	The state of a ROM search in progress, which lets several searches (for example, one
+ *								per DS2482-800 channel) be carried on independently of one another.
+ */
+struct OneWireSearchState {
+	uint8_t searchAddress[8];		/*!< The ROM found by the last search pass */
+	uint8_t searchLastDiscrepancy;	/*!< The bit position (1-64) of the last discrepancy where the 0 branch was taken;
+										 0 if there was none */
+	uint8_t searchLastDeviceFlag;	/*!< Set once the last device on the bus has been found */
+	uint8_t searchFamily;			/*!< The family code a targeted search is restricted to; 0 if not targeted */
+};
+
+
+/**
+ * \def ONEWIRE_SEARCH_RETRIES	How many times searchAll() repeats a search pass which failed, or returned a ROM with a
+ *								bad CRC, before it gives up on the rest of the bus.
+ */
+#ifndef ONEWIRE_SEARCH_RETRIES
+#define ONEWIRE_SEARCH_RETRIES			2
+#endif
+
+
+/**
+ * \struct OneWireSearchReport	What a complete enumeration of the bus with searchAll() found, and what it cost.
+ */
+struct OneWireSearchReport {
+	uint8_t devices;				/*!< ROMs found, with a valid CRC */
+	uint8_t complete;				/*!< 1 if the whole bus was enumerated; 0 if it was cut short */
+	uint8_t crcErrors;				/*!< Passes which returned a ROM with a bad CRC */
+	uint8_t retries;				/*!< Passes which were repeated, after a CRC error or a failed pass */
+	uint16_t passes;				/*!< Search passes run, including repeated ones */
+	uint32_t polls;					/*!< Status register reads made while waiting for the bridge */
+	uint32_t transactions;			/*!< I2C transactions; only counted when ONEWIRE_ENABLE_STATS is set, 0 otherwise */
+	uint32_t micros;				/*!< Total time taken, in microseconds */
+};
+
+
+/**
+ * \def ONEWIRE_ENABLE_STATS	When defined as 1, OneWire keeps the counters and timings of OneWireStats. It changes the
+ *								layout of the class, so it must be set for the whole build (e.g. with a -D build flag),
+ *								not just in a sketch.
+ */
+#ifndef ONEWIRE_ENABLE_STATS
+#define ONEWIRE_ENABLE_STATS			0
+#endif
+
+/**
+ * \defgroup statDefinitions	The operations OneWireStats keeps timings for. The time waitOnBusy() spends is included
+ *								in the time of the operation which called it.
+ * @{
+ */
+#define ONEWIRE_STAT_RESET				0	/*! wireReset() */
+#define ONEWIRE_STAT_WRITE				1	/*! wireWriteByte() and wireWriteBytes() */
+#define ONEWIRE_STAT_READ				2	/*! wireReadByte(), wireReadBytes() and wireReadBytesCrc16() */
+#define ONEWIRE_STAT_BIT				3	/*! wireWriteBit() and wireReadBit() */
+#define ONEWIRE_STAT_SEARCH				4	/*! A single pass of wireSearch() or wireAlarmSearch() */
+#define ONEWIRE_STAT_WAIT				5	/*! waitOnBusy() */
+#define ONEWIRE_STAT_OPS				6
+/**
+ * @}
+ */
+
+
+/**
+ * \struct OneWireOpStats	How often an operation was run, and how long it took.
+ */
+struct OneWireOpStats {
+	uint32_t count;				/*!< Number of times the operation was run */
+	uint32_t totalMicros;		/*!< Total time, in microseconds */
+	uint32_t maxMicros;			/*!< Longest single run, in microseconds */
+};
+
+/**
+ * \struct OneWireStats	Counters kept by OneWire when ONEWIRE_ENABLE_STATS is set.
+ */
+struct OneWireStats {
+	uint32_t i2cWrites;			/*!< I2C write transactions (including failed ones) */
+	uint32_t i2cReads;			/*!< I2C read transactions */
+	uint32_t i2cNacks;			/*!< I2C write transactions which were not acknowledged */
+	uint32_t polls;				/*!< Status register reads made by waitOnBusy() */
+	uint32_t retries;			/*!< 1-Wire commands which had to be sent again because the bridge was still busy */
+	uint32_t timeouts;			/*!< waitOnBusy() calls which gave up on the busy bit */
+	uint32_t shorts;			/*!< Resets which detected a short on the 1-Wire line */
+	uint32_t crcErrors;			/*!< CRC failures reported with noteCrcError() */
+	OneWireOpStats ops[ONEWIRE_STAT_OPS];	/*!< Timings, indexed by the ONEWIRE_STAT_ operations */
+};
+
+/**
+ * A wait hook is called instead of delayMicroseconds() whenever the library has to wait, so that an RTOS build can
+ * give the time to other tasks. It must not return before the time has passed.
+ *
+ * \param[in]	duration	The time to wait, in microseconds.
+ * \param[in]	context		The context pointer given to setWaitHook().
+ */
+typedef void (*OneWireWaitHook)(uint32_t duration, void *context);
+
+/**
+ * A lock hook takes (acquire = 1) or gives back (acquire = 0) a mutex guarding the bridge. Transactions nest, so the
+ * mutex must be recursive: the task which holds it must be able to take it again (e.g. xSemaphoreTakeRecursive() on
+ * FreeRTOS, or a Zephyr k_mutex).
+ *
+ * \param[in]	acquire	1 to take the mutex, 0 to give it back.
+ * \param[in]	context	The context pointer given to setLockHook().
+ */
+typedef void (*OneWireLockHook)(uint8_t acquire, void *context);
+
+/**
+ * \def ONEWIRE_HAVE_SLEEP_WAIT	Set when the core runs on an RTOS which OneWire::sleepWait() knows how to sleep on.
+ */
+#if defined(INC_FREERTOS_H) || defined(__ZEPHYR__)
+#define ONEWIRE_HAVE_SLEEP_WAIT			1
+#else
+#define ONEWIRE_HAVE_SLEEP_WAIT			0
+#endif
 
 
 /**
@@ -108,6 +317,21 @@ public:
 	 */
 	OneWire(uint8_t address);
 
+	/**
+	 * The constructor for an instance of a OneWire object on a specific I²C bus, such as \c Wire1 or \c Wire2, so that
+	 * bridges on several I²C buses can be driven independently. Unlike the other constructors, this does not call
+	 * \c begin() on the bus: it must be set up (pins, clock) by the sketch before the bridge is used.
+	 *
+	 * \param[in]	address	The state of the AD1/AD0 address pins of the DS2482 chip (0-3).
+	 * \param[in]	wire	The I²C bus the DS2482 chip is connected to.
+	 */
+	OneWire(uint8_t address, OneWireI2C &wire);
+
+	/**
+	 * \return	The I²C bus the DS2482 chip is driven through.
+	 */
+	OneWireI2C &getWire();
+
 	/**
 	 * \fn getAddress
 	 *
@@ -116,12 +340,26 @@ public:
 	uint8_t getAddress();
 
 	/**
+	 * Errors accumulate until they are cleared, so a failure is not lost when a later primitive flags another one.
+	 *
 	 * \fn getError
 	 *
-	 * \return
+	 * \return	The DS2482_ERROR_ flags raised since the last clearError().
 	 */
 	uint8_t getError();
 
+	/**
+	 * \brief Clears the error flags.
+	 */
+	void clearError();
+
+	/**
+	 * \fn getChannel
+	 *
+	 * \return	The active 1-Wire channel, or DS2482_CHANNEL_UNKNOWN if it has not been established yet.
+	 */
+	uint8_t getChannel();
+
 	/**
 	 * \fn checkPresence
 	 *
@@ -130,10 +368,46 @@ public:
 	uint8_t checkPresence();
 
 	/**
+	 * Resets the bridge, then applies the bus profile to the config register it has just cleared.
+	 *
 	 * \fn deviceReset
 	 */
 	void deviceReset();
 
+	/**
+	 * Sets how the bus is driven: ONEWIRE_PROFILE_APU enables the active pullup, which long lines and star topologies
+	 * need to get clean rising edges; ONEWIRE_PROFILE_OVERDRIVE selects overdrive speed; ONEWIRE_PROFILE_NO_SPU turns
+	 * strong pullup requests into no-ops, for buses without parasitically-powered devices. The profile is applied to
+	 * the config register straight away (if it differs from the shadow copy), and again after every deviceReset(), so
+	 * normal operation never has to touch the config register for it.
+	 *
+	 * \brief Sets the bus profile.
+	 *
+	 * \param[in]	profile	A combination of the ONEWIRE_PROFILE_* flags, or one of the presets ONEWIRE_PROFILE_SHORT or
+	 *						ONEWIRE_PROFILE_LONG.
+	 */
+	void setBusProfile(uint8_t profile);
+
+	/**
+	 * \return	The bus profile set with setBusProfile().
+	 */
+	uint8_t getBusProfile();
+
+	/**
+	 * Selects the active 1-Wire channel of a DS2482-800. The Channel Select command is only issued when the requested
+	 * channel differs from the one the bridge is known to be on, so switching back and forth between the same channels
+	 * costs nothing until the channel actually changes. A device reset returns the bridge to channel 0.
+	 *
+	 * \brief Selects the active 1-Wire channel.
+	 *
+	 * \param[in]	channel	The channel to select, from 0 to 7.
+	 *
+	 * \return		Indicates whether the channel is now active.
+	 * \retval	0	The channel number is out of range, or the bridge did not confirm the selection.
+	 * \retval	1	The channel is active.
+	 */
+	uint8_t selectChannel(uint8_t channel);
+
 	/**
 	 * Sets the read pointer to the specified register. This action overwrites the read pointer position of any 1-Wire
 	 * communication command that is currently in progress.
@@ -145,26 +419,145 @@ public:
 	void setReadPointer(uint8_t readPointer);
 
 	/**
+	 * Read the status register. The Set Read Pointer command is only sent when the read pointer is not already on the
+	 * status register, which is where every 1-Wire command leaves it; polling the status register while waiting for a
+	 * 1-Wire command to complete therefore costs a single I²C read per poll.
 	 *
-	 * \return
+	 * \brief Read the status register.
+	 *
+	 * \return The contents of the status register.
 	 */
 	uint8_t readStatus();
 
 	/**
+	 * Read the data register, moving the read pointer to it first if necessary.
 	 *
-	 * \return
+	 * \brief Read the data register.
+	 *
+	 * \return The contents of the data register.
 	 */
 	uint8_t readData();
 
 	/**
+	 * Wait for the busy bit in the status register to clear. The duration of the 1-Wire command which was started last
+	 * is known from the datasheet (for the current speed), so the first status read is held off until that command can
+	 * possibly have completed; after that, the status register is polled every setPollInterval() microseconds. If the
+	 * busy bit has not cleared after ONEWIRE_BUSY_TIMEOUT microseconds, DS2482_ERROR_TIMEOUT is flagged.
 	 *
-	 * \return
+	 * \brief Wait for the 1-Wire bus to become free.
+	 *
+	 * \return	The last value read from the status register.
 	 */
 	uint8_t waitOnBusy();
 
 	/**
+	 * Returns how much longer the 1-Wire command started last is certain to keep the bridge busy, based on its
+	 * datasheet duration at the speed it was started at. Until this reaches 0, reading the status register is
+	 * pointless.
 	 *
-	 * \return
+	 * \return	The minimum remaining duration of the last command, in microseconds; 0 if it may already have completed.
+	 */
+	uint16_t busyTimeRemaining();
+
+	/**
+	 * Sets the interval between two status register reads while waiting for the busy bit to clear.
+	 *
+	 * \param[in]	interval	The poll interval, in microseconds.
+	 */
+	void setPollInterval(uint16_t interval);
+
+	/**
+	 * \return	The number of status register reads the last call to waitOnBusy() took.
+	 */
+	uint16_t getLastPollCount();
+
+	/**
+	 * \return	The total number of status register reads waitOnBusy() has made since this object was created.
+	 */
+	uint32_t getTotalPollCount();
+
+	/**
+	 * Replaces the busy waits of waitOnBusy() (and of the helpers built on this object) with a hook, so that the time
+	 * spent waiting for the bridge can be given to other tasks. yieldWait() and sleepWait() cover the common cases.
+	 *
+	 * \brief Sets the function called to wait.
+	 *
+	 * \param[in]	hook	The wait hook, or NULL to go back to delayMicroseconds().
+	 * \param[in]	context	Passed to the hook unchanged.
+	 */
+	void setWaitHook(OneWireWaitHook hook, void *context = 0);
+
+	/**
+	 * Waits through the wait hook, or with delayMicroseconds() if none is set.
+	 *
+	 * \param[in]	duration	The time to wait, in microseconds.
+	 */
+	void pause(uint32_t duration);
+
+	/**
+	 * A wait hook which calls yield() until the time has passed, letting other tasks (or the ESP8266 system) run.
+	 */
+	static void yieldWait(uint32_t duration, void *context);
+
+#if ONEWIRE_HAVE_SLEEP_WAIT
+	/**
+	 * A wait hook which puts the task to sleep: on FreeRTOS, with vTaskDelay() for the duration rounded up to whole
+	 * ticks, at any tick rate (whatever the delay leaves short is yielded away); on Zephyr, with k_usleep().
+	 */
+	static void sleepWait(uint32_t duration, void *context);
+#endif
+
+	/**
+	 * Sets a mutex which lock() and unlock() take and give back. The library's multi-step operations (searches,
+	 * searchAll(), the retry layer, the conversion scheduler) hold it for their whole duration; sequences of
+	 * primitives, such as reset(), select() and read_bytes(), should be wrapped in lock() and unlock() (or a
+	 * OneWireLock) by the caller, so that several tasks can share the bridge.
+	 *
+	 * \brief Sets the hook guarding the bridge against concurrent use.
+	 *
+	 * \param[in]	hook	The lock hook, or NULL if the bridge is only used by one task.
+	 * \param[in]	context	Passed to the hook unchanged.
+	 */
+	void setLockHook(OneWireLockHook hook, void *context = 0);
+
+	/**
+	 * \brief Takes the bridge's mutex; does nothing if no lock hook is set.
+	 */
+	void lock();
+
+	/**
+	 * \brief Gives the bridge's mutex back; does nothing if no lock hook is set.
+	 */
+	void unlock();
+
+	/**
+	 * Reports a CRC failure detected on data read through this object, so that it shows up in the statistics. The
+	 * library's own helpers (e.g. the conversion scheduler and inventory) do this themselves. Does nothing unless
+	 * ONEWIRE_ENABLE_STATS is set.
+	 *
+	 * \brief Counts a CRC failure.
+	 */
+	void noteCrcError();
+
+#if ONEWIRE_ENABLE_STATS
+	/**
+	 * \return	The statistics collected since this object was created, or since the last resetStats().
+	 */
+	const OneWireStats &getStats();
+
+	/**
+	 * Clears all statistics.
+	 */
+	void resetStats();
+#endif
+
+	/**
+	 * Read the config register, moving the read pointer to it first if necessary. The value read also refreshes the
+	 * shadow copy of the config register which the strong pullup functions work from.
+	 *
+	 * \brief Read the config register.
+	 *
+	 * \return The contents of the config register; the upper 4 bits always read as 0000b.
 	 */
 	uint8_t readConfig();
 
@@ -174,7 +567,7 @@ public:
 	 * the lower 4 bits before writing the data to the register is handled within this function. Confirmation that the
 	 * write was successful is done by reading back the config register, and comparing it against the original byte
 	 * value, as any read actions from the config register have the upper 4 bits set to 0000b; as such, the values
-	 * should match.
+	 * should match. On success, the value written becomes the new shadow copy of the config register.
 	 *
 	 * \brief Write data to the config register.
 	 *
@@ -185,20 +578,104 @@ public:
 	/**
 	 * Enables the strong pullup (SPU) for the next bus operation. After execution of the operation with the strong
 	 * pullup enabled, it will be deactivated, and will need to be set once again, if it is necessary for another
-	 * operation.
+	 * operation. The config register is only written if the shadow copy shows the SPU bit is not already armed. Does
+	 * nothing if the bus profile includes ONEWIRE_PROFILE_NO_SPU.
 	 *
 	 * \brief Enables the strong pullup for the next bus operation.
 	 */
 	void setStrongPullup();
 
 	/**
+	 * Disarms the strong pullup, or ends a strong pullup which is still being driven after a previous Write Byte or
+	 * Single Bit command. The config register is only written if the shadow copy shows the SPU bit set.
 	 *
+	 * \brief Clears the strong pullup bit.
 	 */
 	void clearStrongPullup();
 
 	/**
+	 * Writes a byte with the strong pullup armed, and keeps the strong pullup on for a set time after the byte has
+	 * gone out, for instance for the conversion time of parasitically-powered sensors after a Convert T. This returns
+	 * as soon as the byte has been started: nothing is sent to the bridge while the strong pullup is held, so the I²C
+	 * bus is free for other bridges. pollStrongPullup() ends the window once its time is up.
 	 *
-	 * \return
+	 * \brief Starts a timed strong pullup window.
+	 *
+	 * \param[in]	data		The byte to write; the strong pullup starts once its last time slot is done.
+	 * \param[in]	duration	How long to hold the strong pullup after the byte, in microseconds.
+	 *
+	 * \return	1 if the byte was started, 0 if the bridge did not accept it.
+	 */
+	uint8_t startStrongPullup(uint8_t data, uint32_t duration);
+
+	/**
+	 * Releases the strong pullup (through the config shadow) once the window started by startStrongPullup() is over.
+	 * Until then, it does nothing at all, so it may be called as often as needed.
+	 *
+	 * \brief Ends the strong pullup window when it is due.
+	 *
+	 * \return	1 while the window is still open, 0 once it has been closed (or none was started).
+	 */
+	uint8_t pollStrongPullup();
+
+	/**
+	 * \return	The time left in the strong pullup window, in microseconds; 0 if none is open.
+	 */
+	uint32_t strongPullupRemaining();
+
+	/**
+	 * \defgroup startFuncs	Non-blocking primitives, which start a single 1-Wire command and return as soon as the
+	 *						bridge has accepted it, without waiting for it to complete. They are the building blocks of
+	 *						the blocking functions, and of OneWireAsync. The bridge must be idle when one of them is
+	 *						called; completion is detected by reading the status register until the busy bit clears.
+	 * @{
+	 */
+
+	/**
+	 * Starts a 1-Wire reset/presence-detect cycle; PPD and SD in the status register hold the result once the busy bit
+	 * has cleared. A strong pullup still armed or running is cleared first.
+	 *
+	 * \return	1 if the bridge accepted the command, 0 otherwise.
+	 */
+	uint8_t wireResetStart();
+
+	/**
+	 * Starts writing one byte to the 1-Wire line.
+	 *
+	 * \param[in]	data	The byte to be written.
+	 * \param[in]	power	An optional, unsigned byte value, activates the SPU function when containing a value >= 1.
+	 *
+	 * \return	1 if the bridge accepted the command, 0 otherwise.
+	 */
+	uint8_t wireWriteByteStart(uint8_t data, uint8_t power = 0);
+
+	/**
+	 * Starts reading one byte from the 1-Wire line; the data register holds the byte once the busy bit has cleared.
+	 *
+	 * \return	1 if the bridge accepted the command, 0 otherwise.
+	 */
+	uint8_t wireReadByteStart();
+
+	/**
+	 * Starts a single 1-Wire time slot; SBR in the status register holds the bit read once the busy bit has cleared.
+	 *
+	 * \param[in]	data	The bit to be written; a 1 also serves as a read time slot.
+	 * \param[in]	power	An optional, unsigned byte value, activates the SPU function when containing a value >= 1.
+	 *
+	 * \return	1 if the bridge accepted the command, 0 otherwise.
+	 */
+	uint8_t wireWriteBitStart(uint8_t data, uint8_t power = 0);
+
+	/**
+	 * @}
+	 */
+
+	/**
+	 * Generates a 1-Wire reset/presence-detect cycle at the current speed. If the bus is in overdrive and no device
+	 * answers with a presence pulse, the bridge is switched back to standard speed, as devices drop out of overdrive
+	 * whenever they see a standard speed reset; the next reset is then a standard speed one.
+	 *
+	 * \return	1 if one or more devices answered with a presence pulse, 0 otherwise.
 	 */
 	uint8_t wireReset();
 
@@ -208,8 +685,68 @@ public:
 	 * \param power
 	 */
 	void wireWriteByte(uint8_t data, uint8_t power = 0);
-	
-	void wireWriteBytes(const uint8_t *dbuf, uint16_t count, uint8_t power);
+
+	/**
+	 * Write multiple bytes to the 1-Wire line, one 1-Wire Write Byte command per byte. Each byte is sent once the
+	 * previous one must have gone out (its datasheet duration plus an eighth), without reading the status register in
+	 * between: the DS2482 does not acknowledge, or act on, a 1-Wire command while it is still busy, so a byte which came
+	 * too early is NACKed, and only then is the status register polled and the byte sent again. Each byte normally
+	 * costs one I2C transaction. The last byte is preceded by a status poll when 'power' is set, since arming the
+	 * strong pullup writes the config register.
+	 *
+	 * \brief Write multiple bytes of data to the 1-Wire bus.
+	 *
+	 * \param[in]	dbuf	The data buffer containing the bytes to be written.
+	 * \param[in]	count	The amount of bytes to write.
+	 * \param[in]	power	An optional, unsigned byte value; when >= 1, the SPU function is activated for the last byte.
+	 */
+	void wireWriteBytes(const uint8_t *dbuf, uint16_t count, uint8_t power = 0);
+
+	/**
+	 * Reads multiple bytes from the 1-Wire line, and computes their CRC8 on the way: each byte is folded into the CRC
+	 * while the bridge is busy reading the next one, so checking the CRC takes no extra time once the read is done.
+	 * When the data is followed by its CRC byte (as with a ROM or a DS18B20 scratchpad), reading the CRC byte along
+	 * with it makes the result 0 if the data is valid.
+	 *
+	 * \brief Reads multiple bytes of data from the 1-Wire bus, and computes their CRC8.
+	 *
+	 * \param[out]	buf		The buffer to read the bytes into.
+	 * \param[in]	count	The amount of bytes to read.
+	 * \param[in]	crc		The CRC to continue from, if the bytes follow earlier data under the same CRC.
+	 *
+	 * \return	The CRC8 of the bytes read.
+	 */
+	uint8_t wireReadBytes(uint8_t *buf, uint16_t count, uint8_t crc = 0);
+
+	/**
+	 * Reads multiple bytes from the 1-Wire line, and computes their CRC16 on the way, in the same way that
+	 * wireReadBytes() computes a CRC8. Long reads, such as the pages of a DS2431, can be verified in several chunks by
+	 * passing the result of each chunk on to the next one; the devices send the inverted CRC16, so the data is valid
+	 * if the final result is the complement of the two CRC bytes (see check_crc16()).
+	 *
+	 * \brief Reads multiple bytes of data from the 1-Wire bus, and computes their CRC16.
+	 *
+	 * \param[out]	buf		The buffer to read the bytes into.
+	 * \param[in]	count	The amount of bytes to read.
+	 * \param[in]	crc		The CRC16 to continue from (0 to start a new one).
+	 *
+	 * \return	The CRC16 of the bytes read.
+	 */
+	uint16_t wireReadBytesCrc16(uint8_t *buf, uint16_t count, uint16_t crc = 0);
+
+	/**
+	 * Reads multiple bytes without computing any CRC, for protocols which check their data in their own way (CRC16
+	 * blocks, inverted echoes, confirmation bytes). Each Read Byte is given its datasheet duration, after which a single
+	 * status read confirms that the bridge is done before the data register is read: a Read Byte which is still
+	 * running does not make the bridge NACK the data register read, it just returns the previous byte, so the data
+	 * register is never read blind.
+	 *
+	 * \brief Reads multiple bytes of data from the 1-Wire bus, without a CRC.
+	 *
+	 * \param[out]	buf		The buffer to read the bytes into.
+	 * \param[in]	count	The amount of bytes to read.
+	 */
+	void wireStreamBytes(uint8_t *buf, uint16_t count);
 
 	/**
 	 *
@@ -241,11 +778,82 @@ public:
 	 */
 	void wireSelect(const uint8_t rom[8]);
 
+	/**
+	 * Issues a \b RESUME command, which selects the device that was last addressed with a Match ROM (or Overdrive
+	 * Match ROM) command, without sending its ROM again. Only some devices (e.g. DS2413, DS2431, DS28EC20) support it.
+	 *
+	 * \brief Selects the last selected device again.
+	 */
+	void wireResume();
+
+	/**
+	 * Selects a device which supports the Resume command: if it is the device that was last selected through this
+	 * object, a single Resume byte is sent instead of the 9-byte Match ROM. Otherwise, this is the same as
+	 * wireSelect(). It must only be used for devices which support Resume, since others ignore the command.
+	 *
+	 * \brief Selects a device, resuming it if it was the last one selected.
+	 *
+	 * \param[in]	rom	The 64-bit ROM of the device.
+	 *
+	 * \return	1 if the device was resumed, 0 if a full Match ROM was sent.
+	 */
+	uint8_t wireResumeSelect(const uint8_t rom[8]);
+
+	/**
+	 * Forgets which device was last selected, so that the next wireResumeSelect() sends a full Match ROM. This is done
+	 * automatically by the skip, search and channel selection functions, and by a reset without any presence pulse;
+	 * code which sends ROM commands of its own through wireWriteByte() or the non-blocking functions must call it.
+	 *
+	 * \brief Forgets the last selected device.
+	 */
+	void clearLastSelected();
+
+	/**
+	 * Issues an \b OVERDRIVE_SKIP_ROM command at standard speed, then switches the bridge to overdrive speed. Every
+	 * overdrive-capable device on the bus is selected and stays in overdrive until the next standard speed reset.
+	 *
+	 * \brief Issues an OVERDRIVE_SKIP_ROM command.
+	 */
+	void wireOverdriveSkip();
+
+	/**
+	 * Issues an \b OVERDRIVE_MATCH_ROM command at standard speed, then switches the bridge to overdrive speed and sends
+	 * the ROM, as the command requires. Only the matching device is selected and left in overdrive.
+	 *
+	 * \brief Issues an OVERDRIVE_MATCH_ROM command.
+	 *
+	 * \param[in]	rom	An array of 8 unsigned integers (bytes), the 64-bit serial number of the device to select.
+	 */
+	void wireOverdriveSelect(const uint8_t rom[8]);
+
+	/**
+	 * Switches the 1-Wire speed of the bridge by setting or clearing the 1WS bit of the config register. The register
+	 * is only written when the speed actually changes. Note that this does not change the speed of the devices on the
+	 * bus; see wireOverdriveSkip() and wireOverdriveSelect().
+	 *
+	 * \brief Selects standard or overdrive speed.
+	 *
+	 * \param[in]	overdrive	1 to select overdrive speed, 0 to select standard speed.
+	 */
+	void setOverdrive(uint8_t overdrive);
+
+	/**
+	 * \return	1 if the bridge is set to overdrive speed, 0 if it is set to standard speed.
+	 */
+	uint8_t isOverdrive();
+
 	/**
 	 *
 	 */
 	void wireResetSearch();
 
+	/**
+	 * Resets a separately-kept search state, so that the next search using it starts from the beginning.
+	 *
+	 * \param[out]	state	The search state to reset.
+	 */
+	void wireResetSearch(OneWireSearchState &state);
+
 	/**
 	 *
 	 * \param address
@@ -253,6 +861,90 @@ public:
 	 */
 	uint8_t wireSearch(uint8_t *address);
 
+	/**
+	 * Performs one pass of a ROM search, using and updating a separately-kept search state rather than the one built
+	 * into this object.
+	 *
+	 * \param[out]		address	An array of 8 bytes, to which the ROM of the device found is written.
+	 * \param[in,out]	state	The search state to continue from.
+	 *
+	 * \return		1 if a device was found, 0 if there are no (more) devices.
+	 */
+	uint8_t wireSearch(uint8_t *address, OneWireSearchState &state);
+
+	/**
+	 * Sets up the search state so that the following searches only return devices of the specified family. The search
+	 * starts directly in that family's branch of the ROM tree, and finishes as soon as it would leave it, so the
+	 * devices of other families cost no search passes at all.
+	 *
+	 * \brief Restricts the next searches to a single family.
+	 *
+	 * \param[in]	family	The family code to search for.
+	 */
+	void wireTargetSearch(uint8_t family);
+
+	/**
+	 * Sets up a separately-kept search state so that the searches using it only return devices of the specified
+	 * family.
+	 *
+	 * \param[in]	family	The family code to search for.
+	 * \param[out]	state	The search state to set up.
+	 */
+	void wireTargetSearch(uint8_t family, OneWireSearchState &state);
+
+	/**
+	 * Performs one pass of an alarm (conditional) search, which only returns devices whose alarm condition is set,
+	 * such as a temperature sensor which has crossed its TH/TL threshold. It shares the search state, and its
+	 * targeting, with wireSearch(), so a search must be reset before switching between the two.
+	 *
+	 * \brief Searches for the next device in the alarm state.
+	 *
+	 * \param[out]	address	An array of 8 bytes, to which the ROM of the device found is written.
+	 *
+	 * \return		1 if a device was found, 0 if there are no (more) alarming devices.
+	 */
+	uint8_t wireAlarmSearch(uint8_t *address);
+
+	/**
+	 * Performs one pass of an alarm search, using and updating a separately-kept search state.
+	 *
+	 * \param[out]		address	An array of 8 bytes, to which the ROM of the device found is written.
+	 * \param[in,out]	state	The search state to continue from.
+	 *
+	 * \return		1 if a device was found, 0 if there are no (more) alarming devices.
+	 */
+	uint8_t wireAlarmSearch(uint8_t *address, OneWireSearchState &state);
+
+	/**
+	 * Enumerates the whole bus in a single call. The search keeps its own branch state, so the built-in search state
+	 * is not affected; each ROM found is checked against its CRC8, and a pass which fails or returns a bad ROM is run
+	 * again from the same branch point (up to ONEWIRE_SEARCH_RETRIES times), since the state it left behind cannot be
+	 * trusted either.
+	 *
+	 * \brief Finds every device on the bus.
+	 *
+	 * \param[out]	out			The array the ROMs are written to, in the order they are found.
+	 * \param[in]	maxDevices	The number of ROMs the array has room for; the search stops once it is full.
+	 * \param[out]	report		If not NULL, receives the statistics of the search.
+	 *
+	 * \return	The number of ROMs written to the array.
+	 */
+	uint8_t searchAll(uint8_t (*out)[8], uint8_t maxDevices, OneWireSearchReport *report = 0);
+
+	/**
+	 * Checks whether the device with the specified ROM is on the bus, by running a search pass which always takes the
+	 * branch of that ROM. The pass is abandoned at the first bit where the bus no longer offers the ROM's branch, so a
+	 * missing device costs as many triplets as it shares leading bits with a device which is present; a device which
+	 * is present always costs the full 64, as it does in a search. The search state is not affected.
+	 *
+	 * \brief Verifies that a device is present.
+	 *
+	 * \param[in]	rom	The 64-bit ROM of the device.
+	 *
+	 * \return	1 if the device is present, 0 otherwise.
+	 */
+	uint8_t wireVerify(const uint8_t rom[8]);
+
 	/**
 	 * \defgroup emuFuncs	Functions which emulate the "standard" Arduino OneWire library, in an attempt to provide
 	 *						"drop-in" replacement compatibility, for easy migration to a dedicated OneWire controller.
@@ -322,9 +1014,11 @@ public:
 	/**
 	 * Write multiple bytes to the 1-Wire bus.
 	 *
-	 * \param buf
-	 * \param count
-	 * \param power
+	 * \brief Write multiple bytes.
+	 *
+	 * \param[in]	buf		The data buffer containing the bytes to be written to the bus.
+	 * \param[in]	count	The amount of bytes to write to the 1-Wire bus.
+	 * \param[in]	power	An optional parameter; if set to '1', the strong pullup is activated after the last byte.
 	 */
 	void write_bytes(const uint8_t *buf, uint16_t count, uint8_t power = 0);
 
@@ -339,7 +1033,12 @@ public:
 	uint8_t read(void);
 
 	/**
-	 * Read multiple bytes from the 1-Wire bus, storing them in a data buffer.
+	 * Read multiple bytes from the 1-Wire bus, storing them in a data buffer. The Read Byte commands are chained: the
+	 * bridge is only waited on once up front, each following byte is started as soon as the status register (which the
+	 * read pointer is already parked on) reports the previous one done, and the data register is then fetched with a
+	 * single pointer move.
+	 *
+	 * \brief Read multiple bytes.
 	 *
 	 * \param[out]	buf	 	The data buffer to which the data read from the 1-Wire bus will be stored to
 	 * \param[in]	count	The amount of bytes to read from the 1-Wire bus
@@ -369,11 +1068,9 @@ public:
 
 	/**
 	 * Remove power from the bus. Only necessary after a write() call with the 'power' parameter set to '1', or if the
-	 * write_bit() function was called.
+	 * write_bit() function was called. Also closes a window opened with startStrongPullup() early.
 	 *
 	 * \brief Remove power from the bus.
-	 *
-	 * \note This function may not be applicable in the context of the DS2482 series of devices.
 	 */
 	void depower(void);
 
@@ -383,17 +1080,19 @@ public:
 	void reset_search();
 
 	/**
+	 * \brief Restricts the next searches to the devices of a single family.
 	 *
-	 * \param family_code
+	 * \param[in]	family_code	The family code to search for.
 	 */
 	void target_search(uint8_t family_code);
 
 	/**
 	 *
 	 * \param newAddr
+	 * \param search_mode	1 (the default) for a normal search, 0 for an alarm search.
 	 * \return
 	 */
-	uint8_t search(uint8_t *newAddr);
+	uint8_t search(uint8_t *newAddr, uint8_t search_mode = 1);
 
 	/**
 	 *
@@ -403,22 +1102,147 @@ public:
 	 */
 	static uint8_t crc8(const uint8_t *addr, uint8_t len);
 
+	/**
+	 * Continues a Dallas CRC8 with a single byte, so that the CRC of data can be computed as it is streamed.
+	 *
+	 * \param[in]	crc		The CRC so far (0 to start a new one).
+	 * \param[in]	data	The next byte.
+	 *
+	 * \return	The CRC including that byte.
+	 */
+	static uint8_t crc8Update(uint8_t crc, uint8_t data);
+
+	/**
+	 * Computes the Dallas CRC16 (polynomial x^16 + x^15 + x^2 + 1) of a buffer, as the original OneWire library does.
+	 * The devices send the complement of this value, least significant byte first.
+	 *
+	 * \param[in]	input	The data to compute the CRC16 of.
+	 * \param[in]	len		The amount of bytes in the data.
+	 * \param[in]	crc		The CRC16 to continue from; usually 0, but some devices seed it with e.g. the page address.
+	 *
+	 * \return	The CRC16 (not inverted).
+	 */
+	static uint16_t crc16(const uint8_t *input, uint16_t len, uint16_t crc = 0);
+
+	/**
+	 * Checks a buffer against the inverted CRC16 a device has sent with it, as the original OneWire library does.
+	 *
+	 * \param[in]	input			The data to check.
+	 * \param[in]	len				The amount of bytes in the data.
+	 * \param[in]	inverted_crc	The two CRC bytes, as received from the device.
+	 * \param[in]	crc				The CRC16 to continue from.
+	 *
+	 * \return	1 if the CRC matches, 0 otherwise.
+	 */
+	static uint8_t check_crc16(const uint8_t *input, uint16_t len, const uint8_t *inverted_crc, uint16_t crc = 0);
+
+	/**
+	 * Continues a Dallas CRC16 with a single byte, so that the CRC16 of data can be computed as it is streamed.
+	 *
+	 * \param[in]	crc		The CRC16 so far (0 to start a new one).
+	 * \param[in]	data	The next byte.
+	 *
+	 * \return	The CRC16 including that byte.
+	 */
+	static uint16_t crc16Update(uint16_t crc, uint8_t data);
+
 	/**
 	 * @}
 	 */
 
 private:
+	void init(uint8_t address, OneWireI2C &wire);
 	void begin();
 	uint8_t end();
 	void writeByte(uint8_t);
 	uint8_t readByte();
+	uint8_t wireCommand(uint8_t command);
+	uint8_t wireCommand(uint8_t command, uint8_t param);
+	uint8_t wireCommandSent(uint8_t command);
+	uint16_t commandDuration(uint8_t command);
+	uint8_t cachedConfig();
+	void waitOnCommand();
+	void readBytes(uint8_t *buf, uint16_t count, uint8_t *crc8, uint16_t *crc16);
+#if ONEWIRE_ENABLE_STATS
+	void statTime(uint8_t op, uint32_t start);
+#endif
+	uint8_t searchRom(uint8_t command, uint8_t *address, OneWireSearchState &state);
+	uint8_t wireTriplet(uint8_t direction);
 
+	OneWireI2C *mWire;
 	uint8_t mAddress;
 	uint8_t mError;
 
-	uint8_t searchAddress[8];
-	uint8_t searchLastDiscrepancy;
-	uint8_t searchLastDeviceFlag;
+	/* The register the DS2482 read pointer is known to be on, or DS2482_POINTER_UNKNOWN */
+	uint8_t mReadPointer;
+
+	/* Shadow of the config register (APU/SPU/1WS), or DS2482_CONFIG_UNKNOWN */
+	uint8_t mConfig;
+
+	/* The ONEWIRE_PROFILE_* flags that deviceReset() restores */
+	uint8_t mProfile;
+
+	/* A strong pullup is being driven after a Write Byte/Single Bit; the next 1-Wire command ends it and clears SPU */
+	uint8_t mPullupActive;
+
+	/* The timed strong pullup window of startStrongPullup(), counted from the start of its byte; 0 if none is open */
+	uint32_t mPullupStart;
+	uint32_t mPullupWindow;
+
+	/* The currently selected DS2482-800 channel, or DS2482_CHANNEL_UNKNOWN */
+	uint8_t mChannel;
+
+	/* When the last 1-Wire command was started, and how long (at minimum) it keeps the bridge busy */
+	uint32_t mCommandStart;
+	uint16_t mCommandDuration;
+
+	uint16_t mPollInterval;
+	uint16_t mLastPollCount;
+	uint32_t mTotalPollCount;
+
+	OneWireSearchState mSearch;
+
+	/* The ROM of the last device selected with Match ROM, which Resume would select again; valid if mLastRomValid */
+	uint8_t mLastRom[8];
+	uint8_t mLastRomValid;
+
+	OneWireWaitHook mWaitHook;
+	void *mWaitContext;
+	OneWireLockHook mLockHook;
+	void *mLockContext;
+
+#if ONEWIRE_ENABLE_STATS
+	OneWireStats mStats;
+#endif
+};
+
+
+/**
+ * \class OneWireLock	Holds the lock of a bridge for as long as it is in scope.
+ * \code{.cpp}
+ * {
+ *     OneWireLock guard(oneWire);
+ *     oneWire.reset();
+ *     oneWire.select(rom);
+ *     ...
+ * }
+ * \endcode
+ */
+class OneWireLock {
+public:
+	OneWireLock(OneWire &bus) : mBus(bus) {
+		mBus.lock();
+	}
+
+	~OneWireLock() {
+		mBus.unlock();
+	}
+
+private:
+	OneWireLock(const OneWireLock &);
+	OneWireLock &operator=(const OneWireLock &);
+
+	OneWire &mBus;
 };
 
 #endif	/* _DS2482OW__SRC_ONEWIRE_H__ */
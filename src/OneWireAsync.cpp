@@ -0,0 +1,193 @@
+/**
+ * \file OneWireAsync.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireAsync.h"
+
+
+OneWireAsync::OneWireAsync(OneWire &bus) : mBus(bus) {
+	mPhase = PHASE_IDLE;
+	mIndex = 0;
+	mError = ONEWIRE_ASYNC_ERROR_NONE;
+	mTimeout = ONEWIRE_ASYNC_DEFAULT_TIMEOUT;
+	mCommandStart = 0;
+}
+
+
+uint8_t OneWireAsync::submit(const OneWireTransaction &txn) {
+	if (isBusy()) {
+		return false;
+	}
+
+	mTxn = txn;
+	mIndex = 0;
+	mError = ONEWIRE_ASYNC_ERROR_NONE;
+
+	/* Nothing is sent yet; the first poll() makes sure the bridge is idle before starting the first command */
+	mPhase = PHASE_START;
+	mCommandStart = micros();
+
+	return true;
+}
+
+
+void OneWireAsync::abort() {
+	mPhase = PHASE_IDLE;
+}
+
+
+uint8_t OneWireAsync::isBusy() {
+	return (mPhase != PHASE_IDLE && mPhase != PHASE_DONE && mPhase != PHASE_ERROR) ? true : false;
+}
+
+
+uint8_t OneWireAsync::getError() {
+	return mError;
+}
+
+
+void OneWireAsync::setTimeout(uint32_t timeout) {
+	mTimeout = timeout;
+}
+
+
+OneWire &OneWireAsync::getBus() {
+	return mBus;
+}
+
+
+uint8_t OneWireAsync::poll() {
+	switch (mPhase) {
+		case PHASE_IDLE:
+			return ONEWIRE_ASYNC_IDLE;
+		case PHASE_DONE:
+			return ONEWIRE_ASYNC_DONE;
+		case PHASE_ERROR:
+			return ONEWIRE_ASYNC_ERROR;
+		default:
+			break;
+	}
+
+	/* Reading the status register before the command's datasheet duration has passed would only waste I2C time */
+	if ((mPhase != PHASE_START) && mBus.busyTimeRemaining()) {
+		return ONEWIRE_ASYNC_PENDING;
+	}
+
+	/* One status read per poll; every 1-Wire command leaves the read pointer there, so this is a single I2C read */
+	uint8_t status = mBus.readStatus();
+
+	if (status & DS2482_STATUS_BUSY) {
+		if ((micros() - mCommandStart) > mTimeout) {
+			return fail(ONEWIRE_ASYNC_ERROR_TIMEOUT);
+		}
+		return ONEWIRE_ASYNC_PENDING;
+	}
+
+	/* Collect the result of the command which has just completed */
+	switch (mPhase) {
+		case PHASE_RESET:
+			if (status & DS2482_STATUS_SD) {
+				return fail(ONEWIRE_ASYNC_ERROR_SHORT);
+			}
+			if (!(status & DS2482_STATUS_PPD)) {
+				return fail(ONEWIRE_ASYNC_ERROR_PRESENCE);
+			}
+			break;
+
+		case PHASE_READ:
+			mTxn.readBuffer[mIndex++] = mBus.readData();
+			break;
+
+		default:
+			break;
+	}
+
+	return startNext();
+}
+
+
+/**
+ * Works out which 1-Wire command comes next, and starts it. Phases with nothing to do are passed straight through, so
+ * that exactly one command is started per call (or the transaction completes).
+ */
+uint8_t OneWireAsync::startNext() {
+	for (;;) {
+		switch (mPhase) {
+			case PHASE_START:
+				mPhase = PHASE_RESET;
+				if (mTxn.flags & ONEWIRE_TXN_RESET) {
+					return started(mBus.wireResetStart());
+				}
+				break;
+
+			case PHASE_RESET:
+				mPhase = PHASE_ROM;
+				/* The ROM command below is sent behind the bus's back, so it can no longer resume its last device */
+				if (mTxn.rom || (mTxn.flags & ONEWIRE_TXN_SKIP)) {
+					mBus.clearLastSelected();
+				}
+				if (mTxn.rom) {
+					mIndex = 0;
+					return started(mBus.wireWriteByteStart(WIRE_COMMAND_SELECT));
+				}
+				/* Without a ROM, there are no ROM bytes to follow the (optional) ROM command */
+				mIndex = 8;
+				if (mTxn.flags & ONEWIRE_TXN_SKIP) {
+					return started(mBus.wireWriteByteStart(WIRE_COMMAND_SKIP));
+				}
+				break;
+
+			case PHASE_ROM:
+				if (mIndex < 8) {
+					return started(mBus.wireWriteByteStart(mTxn.rom[mIndex++]));
+				}
+				mPhase = PHASE_WRITE;
+				mIndex = 0;
+				break;
+
+			case PHASE_WRITE:
+				if (mIndex < mTxn.writeLength) {
+					uint8_t power = (mTxn.flags & ONEWIRE_TXN_POWER) && (mIndex == mTxn.writeLength - 1);
+					return started(mBus.wireWriteByteStart(mTxn.writeBuffer[mIndex++], power));
+				}
+				mPhase = PHASE_READ;
+				mIndex = 0;
+				break;
+
+			case PHASE_READ:
+				/* mIndex only moves on once the byte has been fetched from the data register */
+				if (mIndex < mTxn.readLength) {
+					return started(mBus.wireReadByteStart());
+				}
+				mPhase = PHASE_DONE;
+				return ONEWIRE_ASYNC_DONE;
+
+			default:
+				/* Finished (or never started) transactions don't start anything; report their result */
+				return poll();
+		}
+	}
+}
+
+
+uint8_t OneWireAsync::started(uint8_t accepted) {
+	if (!accepted) {
+		return fail(ONEWIRE_ASYNC_ERROR_BRIDGE);
+	}
+
+	mCommandStart = micros();
+	return ONEWIRE_ASYNC_PENDING;
+}
+
+
+uint8_t OneWireAsync::fail(uint8_t error) {
+	mError = error;
+	mPhase = PHASE_ERROR;
+	return ONEWIRE_ASYNC_ERROR;
+}
@@ -0,0 +1,157 @@
+/**
+ * \file OneWireAsync.h
+ * Provides a non-blocking way of running 1-Wire transactions: a transaction is submitted once, and then driven to
+ * completion by calling poll() from the sketch's main loop, instead of blocking inside waitOnBusy().
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREASYNC_H__
+#define _DS2482OW__SRC_ONEWIREASYNC_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup asyncDefinitions	Transaction flags and poll() results.
+ * @{
+ */
+#define ONEWIRE_TXN_RESET			(1<<0)	/*! Start the transaction with a 1-Wire reset, and require a presence pulse */
+#define ONEWIRE_TXN_SKIP			(1<<1)	/*! Address all devices with SKIP_ROM (when no ROM is given) */
+#define ONEWIRE_TXN_POWER			(1<<2)	/*! Enable the strong pullup after the last byte written */
+
+#define ONEWIRE_ASYNC_IDLE			0		/*! No transaction has been submitted */
+#define ONEWIRE_ASYNC_PENDING		1		/*! The transaction is still in progress; keep calling poll() */
+#define ONEWIRE_ASYNC_DONE			2		/*! The transaction has completed successfully */
+#define ONEWIRE_ASYNC_ERROR			3		/*! The transaction has failed; see getError() */
+
+#define ONEWIRE_ASYNC_ERROR_NONE		0	/*! No error */
+#define ONEWIRE_ASYNC_ERROR_PRESENCE	1	/*! No device answered the reset with a presence pulse */
+#define ONEWIRE_ASYNC_ERROR_SHORT		2	/*! The reset detected a short on the 1-Wire line */
+#define ONEWIRE_ASYNC_ERROR_TIMEOUT		3	/*! The bridge stayed busy for longer than the timeout */
+#define ONEWIRE_ASYNC_ERROR_BRIDGE		4	/*! The bridge did not acknowledge a command */
+
+#define ONEWIRE_ASYNC_DEFAULT_TIMEOUT	20000	/*! Default busy timeout, in microseconds; matches waitOnBusy() */
+/**
+ * @}
+ */
+
+
+/**
+ * \struct OneWireTransaction	Describes one complete 1-Wire transaction: an optional reset, an optional ROM command,
+ *								a number of bytes written, then a number of bytes read. The buffers are owned by the
+ *								caller and must stay valid until the transaction has completed.
+ */
+struct OneWireTransaction {
+	uint8_t flags;					/*!< A combination of the ONEWIRE_TXN_ flags */
+	const uint8_t *rom;				/*!< The ROM to address with MATCH_ROM, or NULL */
+	const uint8_t *writeBuffer;		/*!< The bytes to write after the ROM command */
+	uint16_t writeLength;			/*!< The amount of bytes to write */
+	uint8_t *readBuffer;			/*!< The buffer the bytes read are stored to */
+	uint16_t readLength;			/*!< The amount of bytes to read */
+};
+
+
+/**
+ * \class OneWireAsync	Runs OneWireTransaction descriptors on a OneWire bus as a non-blocking state machine.
+ *
+ * Each call to poll() reads the status register once. If the bridge is still busy it returns straight away;
+ * otherwise it collects the result of the command which has just finished, and starts the next one. A call to poll()
+ * therefore never waits for the 1-Wire bus, and costs at most a handful of I²C transactions.
+ *
+ * \code{.cpp}
+ * uint8_t command = 0xBE;
+ * uint8_t scratchpad[9];
+ * OneWireTransaction txn = { ONEWIRE_TXN_RESET, rom, &command, 1, scratchpad, 9 };
+ *
+ * oneWireAsync.submit(txn);
+ * ...
+ * void loop() {
+ *     if (oneWireAsync.poll() == ONEWIRE_ASYNC_DONE) {
+ *         // scratchpad[] is ready
+ *     }
+ * }
+ * \endcode
+ */
+class OneWireAsync {
+public:
+	/**
+	 * \param[in]	bus	The bus the transactions are run on.
+	 */
+	OneWireAsync(OneWire &bus);
+
+	/**
+	 * Submits a transaction. The descriptor is copied, but the buffers it points to are used in place.
+	 *
+	 * \param[in]	txn	The transaction to run.
+	 *
+	 * \return	1 if the transaction was accepted, 0 if another transaction is still pending.
+	 */
+	uint8_t submit(const OneWireTransaction &txn);
+
+	/**
+	 * Advances the pending transaction by at most one 1-Wire command.
+	 *
+	 * \return	One of the ONEWIRE_ASYNC_ result values. Once a transaction has completed, the same result is returned
+	 *			until the next one is submitted.
+	 */
+	uint8_t poll();
+
+	/**
+	 * Abandons the pending transaction. The 1-Wire command in progress, if any, is still completed by the bridge.
+	 */
+	void abort();
+
+	/**
+	 * \return	1 if a transaction is pending, 0 otherwise.
+	 */
+	uint8_t isBusy();
+
+	/**
+	 * \return	The ONEWIRE_ASYNC_ERROR_ code of the last transaction which failed.
+	 */
+	uint8_t getError();
+
+	/**
+	 * Sets how long the bridge may stay busy with a single 1-Wire command before the transaction is failed.
+	 *
+	 * \param[in]	timeout	The timeout, in microseconds.
+	 */
+	void setTimeout(uint32_t timeout);
+
+	/**
+	 * \return	The bus the transactions are run on.
+	 */
+	OneWire &getBus();
+
+private:
+	enum Phase {
+		PHASE_IDLE,
+		PHASE_START,
+		PHASE_RESET,
+		PHASE_ROM,
+		PHASE_WRITE,
+		PHASE_READ,
+		PHASE_DONE,
+		PHASE_ERROR
+	};
+
+	uint8_t startNext();
+	uint8_t started(uint8_t accepted);
+	uint8_t fail(uint8_t error);
+
+	OneWire &mBus;
+	OneWireTransaction mTxn;
+
+	Phase mPhase;
+	uint16_t mIndex;
+	uint8_t mError;
+
+	uint32_t mTimeout;
+	uint32_t mCommandStart;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREASYNC_H__ */
@@ -0,0 +1,86 @@
+/**
+ * \file OneWireBatch.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireBatch.h"
+
+
+OneWireBatch::OneWireBatch(OneWire &bus) : mBus(bus) {
+	mLastDuration = 0;
+}
+
+
+/**
+ * The bridge's error flags are cleared first, so that an I2C fault, a timeout or a short flagged by any of the
+ * primitives is reported against this transaction. An I2C fault comes first, as a bridge which stopped answering also
+ * leaves the bus looking busy, or empty.
+ */
+uint8_t OneWireBatch::execute(const OneWireTransaction &txn) {
+	OneWireLock guard(mBus);
+
+	mBus.clearError();
+
+	if ((txn.flags & ONEWIRE_TXN_RESET) && !mBus.wireReset()) {
+		if (mBus.getError() & DS2482_ERROR_I2C) {
+			return ONEWIRE_ASYNC_ERROR_BRIDGE;
+		}
+		return (mBus.getError() & DS2482_ERROR_SHORT) ? ONEWIRE_ASYNC_ERROR_SHORT : ONEWIRE_ASYNC_ERROR_PRESENCE;
+	}
+
+	if (txn.rom) {
+		mBus.wireSelect(txn.rom);
+	} else if (txn.flags & ONEWIRE_TXN_SKIP) {
+		mBus.wireSkip();
+	}
+
+	if (txn.writeLength) {
+		mBus.wireWriteBytes(txn.writeBuffer, txn.writeLength, (txn.flags & ONEWIRE_TXN_POWER) ? 1 : 0);
+	}
+
+	if (txn.readLength) {
+		mBus.wireReadBytes(txn.readBuffer, txn.readLength);
+	}
+
+	if (mBus.getError() & DS2482_ERROR_I2C) {
+		return ONEWIRE_ASYNC_ERROR_BRIDGE;
+	}
+	return (mBus.getError() & DS2482_ERROR_TIMEOUT) ? ONEWIRE_ASYNC_ERROR_TIMEOUT : ONEWIRE_ASYNC_ERROR_NONE;
+}
+
+
+uint8_t OneWireBatch::run(const OneWireTransaction *txns, uint8_t count, uint8_t *errors) {
+	OneWireLock guard(mBus);
+	uint32_t start = micros();
+	uint8_t succeeded = 0;
+
+	for (uint8_t i = 0; i < count; i++) {
+		uint8_t error = execute(txns[i]);
+
+		if (errors) {
+			errors[i] = error;
+		}
+		if (error == ONEWIRE_ASYNC_ERROR_NONE) {
+			succeeded++;
+		}
+	}
+
+	mLastDuration = micros() - start;
+
+	return succeeded;
+}
+
+
+uint32_t OneWireBatch::getLastDuration() {
+	return mLastDuration;
+}
+
+
+OneWire &OneWireBatch::getBus() {
+	return mBus;
+}
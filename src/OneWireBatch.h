@@ -0,0 +1,88 @@
+/**
+ * \file OneWireBatch.h
+ * Provides a blocking runner for OneWireTransaction descriptors, which works through a whole batch of them back to
+ * back, without any heap use.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREBATCH_H__
+#define _DS2482OW__SRC_ONEWIREBATCH_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+#include "OneWireAsync.h"
+
+
+/**
+ * \class OneWireBatch	Runs OneWireTransaction descriptors to completion, one after the other.
+ *
+ * The descriptors are the same ones OneWireAsync takes, and fail with the same ONEWIRE_ASYNC_ERROR_ codes. They are
+ * run straight on the bus's primitives: Match ROM and the ROM go out through wireWriteBytes(), one I2C transaction per
+ * byte with no status poll in between, reads poll the bridge once each byte is due, and the read pointer and config
+ * register are only touched when their shadow copies say so. A batch of descriptors which can live in a \c static
+ * array therefore runs in a time which only varies with the bus, which suits fixed-period control loops.
+ *
+ * \code{.cpp}
+ * static const uint8_t convert = 0x44;
+ * static const uint8_t readScratchpad = 0xBE;
+ * static uint8_t scratchpad[2][9];
+ * static const OneWireTransaction cycle[] = {
+ *     { ONEWIRE_TXN_RESET | ONEWIRE_TXN_SKIP, NULL, &convert, 1, NULL, 0 },
+ *     { ONEWIRE_TXN_RESET, rom0, &readScratchpad, 1, scratchpad[0], 9 },
+ *     { ONEWIRE_TXN_RESET, rom1, &readScratchpad, 1, scratchpad[1], 9 },
+ * };
+ * uint8_t errors[3];
+ * ...
+ * batch.run(cycle, 3, errors);
+ * \endcode
+ */
+class OneWireBatch {
+public:
+	/**
+	 * \param[in]	bus	The bus the transactions are run on.
+	 */
+	OneWireBatch(OneWire &bus);
+
+	/**
+	 * Runs a single transaction, and waits for it to complete. The bus's error flags are cleared when it starts, and
+	 * are left holding what this transaction raised: a sketch which keeps its own tally of getError() must read it
+	 * before calling this.
+	 *
+	 * \param[in]	txn	The transaction to run.
+	 *
+	 * \return	ONEWIRE_ASYNC_ERROR_NONE if it succeeded, or the ONEWIRE_ASYNC_ERROR_ code it failed with.
+	 */
+	uint8_t execute(const OneWireTransaction &txn);
+
+	/**
+	 * Runs a batch of transactions, holding the bus's lock for the whole batch. A transaction which fails does not stop
+	 * the ones after it. As with execute(), the bus's error flags are cleared for each transaction, so afterwards they
+	 * only hold what the last one raised.
+	 *
+	 * \param[in]	txns	The transactions to run.
+	 * \param[in]	count	The number of transactions.
+	 * \param[out]	errors	If not NULL, receives the ONEWIRE_ASYNC_ERROR_ code of each transaction.
+	 *
+	 * \return	The number of transactions which succeeded.
+	 */
+	uint8_t run(const OneWireTransaction *txns, uint8_t count, uint8_t *errors = 0);
+
+	/**
+	 * \return	How long the last call to run() took, in microseconds.
+	 */
+	uint32_t getLastDuration();
+
+	/**
+	 * \return	The bus the transactions are run on.
+	 */
+	OneWire &getBus();
+
+private:
+	OneWire &mBus;
+	uint32_t mLastDuration;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREBATCH_H__ */
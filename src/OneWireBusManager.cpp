@@ -0,0 +1,181 @@
+/**
+ * \file OneWireBusManager.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireBusManager.h"
+
+
+OneWireBusManager::OneWireBusManager() {
+	mCount = 0;
+	mPending = 0;
+}
+
+
+uint8_t OneWireBusManager::addBridge(OneWireAsync &engine) {
+	if (mCount >= ONEWIRE_MANAGER_MAX_BRIDGES) {
+		return 0xFF;
+	}
+
+	Lane &lane = mLanes[mCount];
+	lane.engine = &engine;
+	lane.head = 0;
+	lane.tail = 0;
+	lane.running = 0;
+	lane.holdStart = 0;
+	lane.hold = 0;
+
+	return mCount++;
+}
+
+
+uint8_t OneWireBusManager::getBridgeCount() {
+	return mCount;
+}
+
+
+OneWireAsync &OneWireBusManager::getEngine(uint8_t bridge) {
+	return *mLanes[bridge].engine;
+}
+
+
+uint8_t OneWireBusManager::submit(uint8_t bridge, OneWireJob &job) {
+	if (bridge >= mCount) {
+		return false;
+	}
+
+	Lane &lane = mLanes[bridge];
+
+	job.result = ONEWIRE_ASYNC_PENDING;
+	job.error = ONEWIRE_ASYNC_ERROR_NONE;
+	job.next = 0;
+
+	if (lane.tail) {
+		lane.tail->next = &job;
+	} else {
+		lane.head = &job;
+	}
+	lane.tail = &job;
+	mPending++;
+
+	return true;
+}
+
+
+uint16_t OneWireBusManager::poll() {
+	for (uint8_t i = 0; i < mCount; i++) {
+		serve(mLanes[i]);
+	}
+
+	return mPending;
+}
+
+
+void OneWireBusManager::flush() {
+	while (poll()) {
+		yield();
+	}
+}
+
+
+void OneWireBusManager::abort() {
+	for (uint8_t i = 0; i < mCount; i++) {
+		Lane &lane = mLanes[i];
+
+		/* The engine's result belongs to the job being drained, so it must not be picked up by the next poll() */
+		if (lane.running) {
+			lane.engine->abort();
+			lane.running = 0;
+		}
+		while (lane.head) {
+			complete(lane, ONEWIRE_ASYNC_ERROR, ONEWIRE_ASYNC_ERROR_BRIDGE);
+		}
+		lane.hold = 0;
+	}
+}
+
+
+/**
+ * Drives one bridge: advances its running job, and when that is done (and any hold time has passed), starts the next
+ * one straight away, so that the bridge does not sit idle until the next call.
+ */
+uint8_t OneWireBusManager::serve(Lane &lane) {
+	if (lane.running) {
+		uint8_t result = lane.engine->poll();
+
+		if (result == ONEWIRE_ASYNC_PENDING) {
+			return result;
+		}
+
+		/* Only a job which went through needs its hold time, e.g. for a conversion it has started */
+		lane.running = 0;
+		lane.hold = (result == ONEWIRE_ASYNC_DONE) ? lane.head->hold : 0;
+		lane.holdStart = micros();
+		complete(lane, result, lane.engine->getError());
+	}
+
+	if (lane.hold) {
+		if ((micros() - lane.holdStart) < lane.hold) {
+			return ONEWIRE_ASYNC_PENDING;
+		}
+		lane.hold = 0;
+	}
+
+	return start(lane);
+}
+
+
+uint8_t OneWireBusManager::start(Lane &lane) {
+	while (lane.head) {
+		OneWireJob &job = *lane.head;
+		OneWire &bus = lane.engine->getBus();
+
+		/* The previous job has finished, so the bridge is idle and will take the Channel Select straight away */
+		if (job.channel != ONEWIRE_JOB_ANY_CHANNEL && !bus.selectChannel(job.channel)) {
+			complete(lane, ONEWIRE_ASYNC_ERROR, ONEWIRE_ASYNC_ERROR_BRIDGE);
+			continue;
+		}
+
+		lane.engine->submit(job.txn);
+		lane.running = 1;
+
+		/* The first poll checks that the bridge is idle and starts the first command */
+		uint8_t result = lane.engine->poll();
+		if (result != ONEWIRE_ASYNC_PENDING) {
+			lane.running = 0;
+			complete(lane, result, lane.engine->getError());
+			continue;
+		}
+
+		return result;
+	}
+
+	return ONEWIRE_ASYNC_IDLE;
+}
+
+
+/**
+ * Takes the job at the head of the queue off it, with its final result.
+ */
+void OneWireBusManager::complete(Lane &lane, uint8_t result, uint8_t error) {
+	OneWireJob &job = *lane.head;
+
+	lane.head = job.next;
+	if (!lane.head) {
+		lane.tail = 0;
+	}
+	mPending--;
+
+	job.result = result;
+	job.error = (result == ONEWIRE_ASYNC_DONE) ? ONEWIRE_ASYNC_ERROR_NONE : error;
+	job.next = 0;
+
+	if (job.onComplete) {
+		job.onComplete(job);
+	}
+}
@@ -0,0 +1,143 @@
+/**
+ * \file OneWireBusManager.h
+ * Provides a manager which runs queues of 1-Wire transactions on several DS2482 bridges at once, so that a single I²C
+ * bus keeps several 1-Wire segments busy at the same time.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREBUSMANAGER_H__
+#define _DS2482OW__SRC_ONEWIREBUSMANAGER_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+#include "OneWireAsync.h"
+
+
+/**
+ * \def ONEWIRE_MANAGER_MAX_BRIDGES	The number of bridges a OneWireBusManager can drive.
+ */
+#ifndef ONEWIRE_MANAGER_MAX_BRIDGES
+#define ONEWIRE_MANAGER_MAX_BRIDGES		8
+#endif
+
+#define ONEWIRE_JOB_ANY_CHANNEL			0xFF	/*! Run the job on whichever channel the bridge is set to */
+
+
+/**
+ * \struct OneWireJob	A transaction queued on one of the bridges of a OneWireBusManager. Jobs are owned by the caller,
+ *						and must stay valid (along with the buffers of their transaction) until they have completed.
+ */
+struct OneWireJob {
+	OneWireTransaction txn;			/*!< The transaction to run */
+	uint8_t channel;				/*!< The DS2482-800 channel to run it on, or ONEWIRE_JOB_ANY_CHANNEL */
+	uint32_t hold;					/*!< How long, in microseconds, to leave the bridge alone after the transaction,
+										 e.g. to keep a strong pullup on for a conversion; 0 for none */
+	void (*onComplete)(OneWireJob &job);	/*!< Called when the job has completed, or NULL */
+
+	uint8_t result;					/*!< ONEWIRE_ASYNC_PENDING until the job has completed, then ONEWIRE_ASYNC_DONE or
+										 ONEWIRE_ASYNC_ERROR; set by the manager */
+	uint8_t error;					/*!< The ONEWIRE_ASYNC_ERROR_ code of a failed job; set by the manager */
+	OneWireJob *next;				/*!< Links the queue; managed by the manager */
+};
+
+
+/**
+ * \class OneWireBusManager	Interleaves the transactions of several bridges.
+ *
+ * Each bridge is driven by its own OneWireAsync engine, and has a queue of jobs which are run one after the other.
+ * poll() serves every bridge in turn; an engine whose bridge is still busy returns without any I²C traffic, so while
+ * one bridge is clocking out a 1-Wire byte, the I²C bus is free to start or finish commands on the others. Jobs on the
+ * channels of a DS2482-800 go through the same queue, since a bridge only drives one channel at a time.
+ *
+ * \code{.cpp}
+ * OneWire bridge0(0), bridge1(1);
+ * OneWireAsync engine0(bridge0), engine1(bridge1);
+ * OneWireBusManager manager;
+ * ...
+ * manager.addBridge(engine0);
+ * manager.addBridge(engine1);
+ * manager.submit(0, job0);
+ * manager.submit(1, job1);
+ * while (manager.poll()) {
+ *     // do other work
+ * }
+ * \endcode
+ */
+class OneWireBusManager {
+public:
+	OneWireBusManager();
+
+	/**
+	 * Adds a bridge to the manager.
+	 *
+	 * \param[in]	engine	The engine which drives the bridge. It must not be used directly while the manager has jobs
+	 *						queued on it.
+	 *
+	 * \return	The index of the bridge, to submit jobs to; 0xFF if the manager is full.
+	 */
+	uint8_t addBridge(OneWireAsync &engine);
+
+	/**
+	 * \return	The number of bridges added.
+	 */
+	uint8_t getBridgeCount();
+
+	/**
+	 * \param[in]	bridge	The index of the bridge.
+	 *
+	 * \return	The engine driving the bridge.
+	 */
+	OneWireAsync &getEngine(uint8_t bridge);
+
+	/**
+	 * Queues a job on a bridge. Its transaction is started once every job queued on that bridge before it has
+	 * completed.
+	 *
+	 * \param[in]	bridge	The index of the bridge.
+	 * \param[in]	job		The job to queue.
+	 *
+	 * \return	1 if the job was queued, 0 if there is no such bridge.
+	 */
+	uint8_t submit(uint8_t bridge, OneWireJob &job);
+
+	/**
+	 * Advances every bridge by at most one 1-Wire command, and starts the next queued job on any bridge which has
+	 * finished one.
+	 *
+	 * \return	The number of jobs which have not completed yet, on all bridges.
+	 */
+	uint16_t poll();
+
+	/**
+	 * Polls until every queued job has completed.
+	 */
+	void flush();
+
+	/**
+	 * Drops every job which has not been started yet (marking them failed) and abandons the running ones.
+	 */
+	void abort();
+
+private:
+	struct Lane {
+		OneWireAsync *engine;
+		OneWireJob *head;
+		OneWireJob *tail;
+		uint8_t running;
+		uint32_t holdStart;
+		uint32_t hold;
+	};
+
+	uint8_t serve(Lane &lane);
+	uint8_t start(Lane &lane);
+	void complete(Lane &lane, uint8_t result, uint8_t error);
+
+	Lane mLanes[ONEWIRE_MANAGER_MAX_BRIDGES];
+	uint8_t mCount;
+	uint16_t mPending;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREBUSMANAGER_H__ */
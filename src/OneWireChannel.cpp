@@ -0,0 +1,115 @@
+/**
+ * \file OneWireChannel.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireChannel.h"
+
+
+OneWireChannel::OneWireChannel(OneWire &bridge, uint8_t channel) : mBridge(bridge), mChannel(channel) {
+	mBridge.wireResetSearch(mSearch);
+}
+
+
+OneWire &OneWireChannel::getBridge() {
+	return mBridge;
+}
+
+
+uint8_t OneWireChannel::getChannel() {
+	return mChannel;
+}
+
+
+uint8_t OneWireChannel::activate() {
+	return mBridge.selectChannel(mChannel);
+}
+
+// ****************************************
+// The functions below make sure the channel is active, then hand over to the bridge
+// ****************************************
+
+uint8_t OneWireChannel::reset(void) {
+	return activate() ? mBridge.wireReset() : 0;
+}
+
+
+void OneWireChannel::select(const uint8_t rom[8]) {
+	if (activate()) {
+		mBridge.wireSelect(rom);
+	}
+}
+
+
+void OneWireChannel::skip(void) {
+	if (activate()) {
+		mBridge.wireSkip();
+	}
+}
+
+
+void OneWireChannel::write(uint8_t v, uint8_t power) {
+	if (activate()) {
+		mBridge.wireWriteByte(v, power);
+	}
+}
+
+
+void OneWireChannel::write_bytes(const uint8_t *buf, uint16_t count, uint8_t power) {
+	if (activate()) {
+		mBridge.wireWriteBytes(buf, count, power);
+	}
+}
+
+
+uint8_t OneWireChannel::read(void) {
+	return activate() ? mBridge.wireReadByte() : 0xFF;
+}
+
+
+void OneWireChannel::read_bytes(uint8_t *buf, uint16_t count) {
+	if (activate()) {
+		mBridge.read_bytes(buf, count);
+	} else {
+		/* An idle 1-Wire bus reads as all ones */
+		for (uint16_t i = 0; i < count; i++) {
+			buf[i] = 0xFF;
+		}
+	}
+}
+
+
+void OneWireChannel::write_bit(uint8_t v) {
+	if (activate()) {
+		mBridge.wireWriteBit(v);
+	}
+}
+
+
+uint8_t OneWireChannel::read_bit(void) {
+	return activate() ? mBridge.wireReadBit() : 1;
+}
+
+
+void OneWireChannel::reset_search() {
+	mBridge.wireResetSearch(mSearch);
+}
+
+
+void OneWireChannel::target_search(uint8_t family_code) {
+	mBridge.wireTargetSearch(family_code, mSearch);
+}
+
+
+uint8_t OneWireChannel::search(uint8_t *newAddr, uint8_t search_mode) {
+	if (!activate()) {
+		return 0;
+	}
+
+	return search_mode ? mBridge.wireSearch(newAddr, mSearch) : mBridge.wireAlarmSearch(newAddr, mSearch);
+}
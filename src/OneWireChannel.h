@@ -0,0 +1,78 @@
+/**
+ * \file OneWireChannel.h
+ * Provides a handle for one of the eight 1-Wire channels of a DS2482-800, exposing the same "standard" OneWire API as
+ * the OneWire class itself.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIRECHANNEL_H__
+#define _DS2482OW__SRC_ONEWIRECHANNEL_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \class OneWireChannel	A single 1-Wire channel of a DS2482-800.
+ *
+ * Any number of channel handles may share one OneWire bridge object. Each operation makes sure its channel is the
+ * active one before using the bus; as the bridge caches the active channel, the Channel Select command is only sent
+ * when consecutive operations actually go to different channels. Every channel keeps its own search state, so
+ * searches on different channels can be interleaved freely.
+ */
+class OneWireChannel {
+public:
+	/**
+	 * \param[in]	bridge	The DS2482-800 the channel belongs to.
+	 * \param[in]	channel	The channel number, from 0 to 7.
+	 */
+	OneWireChannel(OneWire &bridge, uint8_t channel);
+
+	/**
+	 * \return	The OneWire bridge object the channel belongs to.
+	 */
+	OneWire &getBridge();
+
+	/**
+	 * \return	The channel number.
+	 */
+	uint8_t getChannel();
+
+	/**
+	 * Makes this channel the active channel of the bridge; only issues a Channel Select if it is not already active.
+	 *
+	 * \return	1 if the channel is now active, 0 otherwise.
+	 */
+	uint8_t activate();
+
+	/**
+	 * \defgroup channelEmuFuncs	The "standard" OneWire API, applied to this channel.
+	 * @{
+	 */
+	uint8_t reset(void);
+	void select(const uint8_t rom[8]);
+	void skip(void);
+	void write(uint8_t v, uint8_t power = 0);
+	void write_bytes(const uint8_t *buf, uint16_t count, uint8_t power = 0);
+	uint8_t read(void);
+	void read_bytes(uint8_t *buf, uint16_t count);
+	void write_bit(uint8_t v);
+	uint8_t read_bit(void);
+	void reset_search();
+	void target_search(uint8_t family_code);
+	uint8_t search(uint8_t *newAddr, uint8_t search_mode = 1);
+	/**
+	 * @}
+	 */
+
+private:
+	OneWire &mBridge;
+	uint8_t mChannel;
+
+	OneWireSearchState mSearch;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIRECHANNEL_H__ */
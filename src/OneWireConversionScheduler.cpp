@@ -0,0 +1,260 @@
+/**
+ * \file OneWireConversionScheduler.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireConversionScheduler.h"
+
+
+OneWireConversionScheduler::OneWireConversionScheduler(OneWire &bus, OneWireSensor *sensors, uint8_t capacity) :
+		mBus(bus), mSensors(sensors), mCapacity(capacity) {
+	mCount = 0;
+	mStarted = 0;
+	mParasite = 0;
+	mPending = 0;
+	mSlotPolling = 0;
+	mAllDone = 0;
+}
+
+
+uint8_t OneWireConversionScheduler::addSensor(const uint8_t rom[8], uint8_t resolution) {
+	if (mCount >= mCapacity) {
+		return 0xFF;
+	}
+
+	OneWireSensor &sensor = mSensors[mCount];
+
+	for (uint8_t i = 0; i < 8; i++) {
+		sensor.rom[i] = rom[i];
+	}
+	sensor.resolution = resolution;
+	sensor.state = ONEWIRE_SENSOR_IDLE;
+	sensor.raw = 0;
+
+	return mCount++;
+}
+
+
+void OneWireConversionScheduler::clear() {
+	mCount = 0;
+	mPending = 0;
+}
+
+
+uint8_t OneWireConversionScheduler::getCount() {
+	return mCount;
+}
+
+
+OneWireSensor &OneWireConversionScheduler::getSensor(uint8_t index) {
+	return mSensors[index];
+}
+
+
+float OneWireConversionScheduler::getCelsius(uint8_t index) {
+	return mSensors[index].raw / 16.0f;
+}
+
+
+uint16_t OneWireConversionScheduler::conversionTime(uint8_t resolution) {
+	/* tCONV from the DS18B20 datasheet for 9, 10, 11 and 12 bits, rounded up to whole milliseconds */
+	static const uint16_t times[4] = { 94, 188, 375, 750 };
+
+	if (resolution < 9 || resolution > 12) {
+		return times[3];
+	}
+
+	return times[resolution - 9];
+}
+
+
+/**
+ * When a sensor's conversion is done, counted from the Convert T; the DS18S20 always takes the full 750ms
+ */
+uint16_t OneWireConversionScheduler::deadline(const OneWireSensor &sensor) {
+	if (sensor.rom[0] == ONEWIRE_FAMILY_DS18S20) {
+		return conversionTime(12);
+	}
+
+	return conversionTime(sensor.resolution);
+}
+
+
+uint8_t OneWireConversionScheduler::startConversion(uint8_t parasite) {
+	OneWireLock guard(mBus);
+
+	if (!mBus.reset()) {
+		return false;
+	}
+
+	mBus.skip();
+
+	if (parasite) {
+		/*
+		 * Reading any sensor would end the strong pullup the others still convert on, so it is held for as long as the
+		 * slowest sensor needs, and no sooner; update() reads them all once it has been released.
+		 */
+		uint16_t window = 0;
+		for (uint8_t i = 0; i < mCount; i++) {
+			if (deadline(mSensors[i]) > window) {
+				window = deadline(mSensors[i]);
+			}
+		}
+		mBus.startStrongPullup(WIRE_COMMAND_CONVERT_T, window * 1000UL);
+	} else {
+		mBus.write(WIRE_COMMAND_CONVERT_T);
+	}
+
+	mStarted = millis();
+	mParasite = parasite;
+	mAllDone = 0;
+
+	/* A parasitically powered bus must be left on the strong pullup; read slots would end it */
+	mSlotPolling = !parasite;
+
+	for (uint8_t i = 0; i < mCount; i++) {
+		mSensors[i].state = ONEWIRE_SENSOR_CONVERTING;
+	}
+	mPending = mCount;
+
+	return true;
+}
+
+
+uint8_t OneWireConversionScheduler::update() {
+	OneWireLock guard(mBus);
+	uint8_t read = 0;
+
+	if (!mPending) {
+		return 0;
+	}
+
+	if (mParasite) {
+		if (mBus.pollStrongPullup()) {
+			return 0;
+		}
+		mAllDone = 1;
+	}
+
+	/* Converting devices answer read slots with 0; once the bus reads 1, every conversion on it has finished */
+	if (mSlotPolling && !mAllDone && mBus.wireReadBit()) {
+		mAllDone = 1;
+	}
+
+	for (;;) {
+		uint32_t elapsed = millis() - mStarted;
+		OneWireSensor *next = NULL;
+
+		/* Pick the due sensor with the earliest deadline */
+		for (uint8_t i = 0; i < mCount; i++) {
+			OneWireSensor &sensor = mSensors[i];
+
+			if (sensor.state != ONEWIRE_SENSOR_CONVERTING) {
+				continue;
+			}
+
+			if (!mAllDone && deadline(sensor) > elapsed) {
+				continue;
+			}
+
+			if (!next || deadline(sensor) < deadline(*next)) {
+				next = &sensor;
+			}
+		}
+
+		if (!next) {
+			break;
+		}
+
+		/* Reading a scratchpad starts with a reset, after which read slots no longer report the conversion status */
+		mSlotPolling = 0;
+
+		readSensor(*next);
+		mPending--;
+		read++;
+	}
+
+	return read;
+}
+
+
+uint8_t OneWireConversionScheduler::isComplete() {
+	return mPending ? false : true;
+}
+
+
+uint8_t OneWireConversionScheduler::runConversion(uint8_t parasite) {
+	uint8_t ready = 0;
+
+	if (!startConversion(parasite)) {
+		return 0;
+	}
+
+	while (!isComplete()) {
+		if (!update()) {
+			mBus.pause(1000);
+		}
+	}
+
+	for (uint8_t i = 0; i < mCount; i++) {
+		if (mSensors[i].state == ONEWIRE_SENSOR_READY) {
+			ready++;
+		}
+	}
+
+	return ready;
+}
+
+
+uint8_t OneWireConversionScheduler::readSensor(OneWireSensor &sensor) {
+	uint8_t scratchpad[9];
+
+	if (!mBus.reset()) {
+		sensor.state = ONEWIRE_SENSOR_ERROR;
+		return false;
+	}
+
+	mBus.select(sensor.rom);
+	mBus.write(WIRE_COMMAND_READ_SCRATCHPAD);
+
+	/* Reading the CRC byte along with the data leaves a CRC of 0 if the scratchpad is valid */
+	if (mBus.wireReadBytes(scratchpad, sizeof(scratchpad))) {
+		mBus.noteCrcError();
+		sensor.state = ONEWIRE_SENSOR_ERROR;
+		return false;
+	}
+
+	/*
+	 * A line held low reads as nine zero bytes, whose CRC is 0 as well; no sensor has an all-zero scratchpad, as
+	 * byte 5 is reserved and always reads 0xFF.
+	 */
+	uint8_t bits = 0;
+
+	for (uint8_t i = 0; i < sizeof(scratchpad); i++) {
+		bits |= scratchpad[i];
+	}
+	if (!bits) {
+		sensor.state = ONEWIRE_SENSOR_ERROR;
+		return false;
+	}
+
+	int16_t raw = (int16_t)((scratchpad[1] << 8) | scratchpad[0]);
+
+	if (sensor.rom[0] == ONEWIRE_FAMILY_DS18S20) {
+		/* 0.5°C steps; COUNT_REMAIN and COUNT_PER_C give the extended 1/16°C resolution */
+		raw = (int16_t)((raw << 3) & 0xFFF0) + 12 - scratchpad[6];
+	} else {
+		/* The config register holds the resolution in bits 5-6; the LSBs below it are undefined */
+		sensor.resolution = 9 + ((scratchpad[4] >> 5) & 0x03);
+		raw &= ~((1 << (12 - sensor.resolution)) - 1);
+	}
+
+	sensor.raw = raw;
+	sensor.state = ONEWIRE_SENSOR_READY;
+	return true;
+}
@@ -0,0 +1,178 @@
+/**
+ * \file OneWireConversionScheduler.h
+ * Provides a scheduler for temperature conversions on a bus of DS18B20-style sensors (DS18B20, DS18S20, DS1822): every sensor is told to convert at once, and each one is read as soon as its own conversion is done.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIRECONVERSIONSCHEDULER_H__
+#define _DS2482OW__SRC_ONEWIRECONVERSIONSCHEDULER_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup conversionDefinitions	Sensor commands and states.
+ * @{
+ */
+#define WIRE_COMMAND_CONVERT_T			0x44	/*! The 1-Wire function command to start a temperature conversion */
+#define WIRE_COMMAND_READ_SCRATCHPAD	0xBE	/*! The 1-Wire function command to read the scratchpad */
+
+#define ONEWIRE_FAMILY_DS18S20			0x10	/*! Family code of the DS18S20 (and DS1820) */
+#define ONEWIRE_FAMILY_DS1822			0x22	/*! Family code of the DS1822 */
+#define ONEWIRE_FAMILY_DS18B20			0x28	/*! Family code of the DS18B20 */
+
+#define ONEWIRE_SENSOR_IDLE				0		/*! No conversion has been requested since the sensor was added */
+#define ONEWIRE_SENSOR_CONVERTING		1		/*! A conversion is in progress; the reading is not available yet */
+#define ONEWIRE_SENSOR_READY			2		/*! The scratchpad was read with a valid CRC; the reading is available */
+#define ONEWIRE_SENSOR_ERROR			3		/*! The scratchpad could not be read, failed its CRC, or read as all zeros */
+/**
+ * @}
+ */
+
+
+/**
+ * \struct OneWireSensor	The scheduler's record of one sensor. An array of these is provided by the caller.
+ */
+struct OneWireSensor {
+	uint8_t rom[8];			/*!< The ROM of the sensor */
+	uint8_t resolution;		/*!< The resolution, in bits (9 to 12); refreshed from each scratchpad read */
+	uint8_t state;			/*!< One of the ONEWIRE_SENSOR_ states */
+	int16_t raw;			/*!< The last reading, in 1/16 °C */
+};
+
+
+/**
+ * \class OneWireConversionScheduler	Runs parallel temperature conversions on every sensor of a bus.
+ *
+ * startConversion() broadcasts a single Convert T to all sensors with SKIP_ROM. Each sensor's conversion time follows
+ * from its resolution, so update() knows each one's completion deadline, and reads the scratchpads of the sensors
+ * which are done in order of their deadlines. On externally powered buses, read time slots are issued until the
+ * first scratchpad read; devices hold the line low while they are converting, so a slot reading 1 means every sensor
+ * has finished early, and all of them can be read without waiting for the worst case deadline.
+ *
+ * With a lock hook set on the bus, startConversion() and update() each hold the lock for their own duration only, so
+ * other tasks can use the bridge while the sensors convert. On a parasitically powered bus they must not: any command
+ * ends the strong pullup the conversion runs on.
+ *
+ * \code{.cpp}
+ * OneWireSensor sensors[8];
+ * OneWireConversionScheduler scheduler(oneWire, sensors, 8);
+ * ...
+ * scheduler.addSensor(rom);
+ * scheduler.startConversion();
+ * ...
+ * void loop() {
+ *     scheduler.update();
+ *     if (scheduler.isComplete()) {
+ *         ...
+ *     }
+ * }
+ * \endcode
+ */
+class OneWireConversionScheduler {
+public:
+	/**
+	 * \param[in]	bus			The bus the sensors are on.
+	 * \param[in]	sensors		Caller-provided storage for the sensor records.
+	 * \param[in]	capacity	The number of records the storage has room for.
+	 */
+	OneWireConversionScheduler(OneWire &bus, OneWireSensor *sensors, uint8_t capacity);
+
+	/**
+	 * Adds a sensor to the schedule.
+	 *
+	 * \param[in]	rom			The ROM of the sensor.
+	 * \param[in]	resolution	The resolution the sensor is expected to be configured for, in bits; corrected
+	 *							automatically after the first scratchpad read.
+	 *
+	 * \return	The index of the sensor, or 0xFF if there is no more room.
+	 */
+	uint8_t addSensor(const uint8_t rom[8], uint8_t resolution = 12);
+
+	/**
+	 * Removes all sensors from the schedule.
+	 */
+	void clear();
+
+	/**
+	 * \return	The number of sensors on the schedule.
+	 */
+	uint8_t getCount();
+
+	/**
+	 * Broadcasts a Convert T command to all sensors on the bus.
+	 *
+	 * \param[in]	parasite	Set to 1 if the sensors are parasitically powered; the strong pullup is then held
+	 *							after the command for the conversion time of the slowest sensor (as derived from the
+	 *							resolutions), and all sensors are read once it has been released.
+	 *
+	 * \return	1 if the conversion was started, 0 if no device answered the reset.
+	 */
+	uint8_t startConversion(uint8_t parasite = 0);
+
+	/**
+	 * Reads every sensor whose conversion is known to be done, in order of their deadlines. Does not wait for
+	 * conversions which are still in progress.
+	 *
+	 * \return	The number of sensors read during this call.
+	 */
+	uint8_t update();
+
+	/**
+	 * \return	1 once every sensor of the current conversion has been read (or has failed), 0 otherwise.
+	 */
+	uint8_t isComplete();
+
+	/**
+	 * Starts a conversion, and calls update() until it is complete.
+	 *
+	 * \param[in]	parasite	As for startConversion().
+	 *
+	 * \return	The number of sensors which were read successfully.
+	 */
+	uint8_t runConversion(uint8_t parasite = 0);
+
+	/**
+	 * \param[in]	index	The index of the sensor.
+	 *
+	 * \return	The sensor's record.
+	 */
+	OneWireSensor &getSensor(uint8_t index);
+
+	/**
+	 * \param[in]	index	The index of the sensor.
+	 *
+	 * \return	The last reading of the sensor, in °C.
+	 */
+	float getCelsius(uint8_t index);
+
+	/**
+	 * \param[in]	resolution	A resolution, in bits (9 to 12).
+	 *
+	 * \return	The maximum conversion time at that resolution, in milliseconds.
+	 */
+	static uint16_t conversionTime(uint8_t resolution);
+
+private:
+	uint8_t readSensor(OneWireSensor &sensor);
+	uint16_t deadline(const OneWireSensor &sensor);
+
+	OneWire &mBus;
+	OneWireSensor *mSensors;
+	uint8_t mCapacity;
+	uint8_t mCount;
+
+	uint32_t mStarted;
+	uint8_t mParasite;
+	uint8_t mPending;
+
+	/* Read slots can only be used to detect completion up to the first reset after the Convert T */
+	uint8_t mSlotPolling;
+	uint8_t mAllDone;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIRECONVERSIONSCHEDULER_H__ */
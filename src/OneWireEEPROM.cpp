@@ -0,0 +1,291 @@
+/**
+ * \file OneWireEEPROM.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireEEPROM.h"
+
+
+OneWireEEPROM::OneWireEEPROM(OneWire &bus, const uint8_t rom[8]) : mBus(bus) {
+	for (uint8_t i = 0; i < 8; i++) {
+		mRom[i] = rom[i];
+	}
+
+	mOverdrive = 0;
+	mParasite = 0;
+	mBusOverdrive = 0;
+}
+
+
+void OneWireEEPROM::setOverdrive(uint8_t overdrive) {
+	mOverdrive = overdrive;
+}
+
+
+void OneWireEEPROM::setParasite(uint8_t parasite) {
+	mParasite = parasite;
+}
+
+
+uint16_t OneWireEEPROM::getSize() {
+	return (mRom[0] == ONEWIRE_FAMILY_DS28EC20) ? 2560 : 128;
+}
+
+
+uint16_t OneWireEEPROM::getAddressSpace() {
+	return (mRom[0] == ONEWIRE_FAMILY_DS28EC20) ? 0xA20 : 0x90;
+}
+
+
+uint8_t OneWireEEPROM::getRowSize() {
+	return (mRom[0] == ONEWIRE_FAMILY_DS28EC20) ? 32 : 8;
+}
+
+
+/**
+ * Read Memory has no CRC of its own on these devices, so the range is streamed in one go with wireStreamBytes(),
+ * without a reset or a new command between pages, and without a CRC8 which would mean nothing for this data.
+ */
+uint8_t OneWireEEPROM::read(uint16_t address, uint8_t *buf, uint16_t count) {
+	if ((uint32_t)address + count > getAddressSpace()) {
+		return ONEWIRE_EEPROM_RANGE;
+	}
+
+	OneWireLock guard(mBus);
+
+	if (!select()) {
+		return ONEWIRE_EEPROM_NO_PRESENCE;
+	}
+
+	uint8_t command[3] = { WIRE_COMMAND_EEPROM_READ_MEMORY, (uint8_t)address, (uint8_t)(address >> 8) };
+
+	mBus.wireWriteBytes(command, 3);
+	mBus.wireStreamBytes(buf, count);
+
+	deselect();
+
+	return ONEWIRE_EEPROM_OK;
+}
+
+
+uint8_t OneWireEEPROM::write(uint16_t address, const uint8_t *data, uint16_t count) {
+	if ((uint32_t)address + count > getSize()) {
+		return ONEWIRE_EEPROM_RANGE;
+	}
+
+	return writeRange(address, data, count);
+}
+
+
+uint8_t OneWireEEPROM::writeRegisters(uint16_t address, const uint8_t *data, uint16_t count) {
+	if (address < getSize() || (uint32_t)address + count > getAddressSpace()) {
+		return ONEWIRE_EEPROM_RANGE;
+	}
+
+	return writeRange(address, data, count);
+}
+
+
+uint8_t OneWireEEPROM::writeRange(uint16_t address, const uint8_t *data, uint16_t count) {
+	OneWireLock guard(mBus);
+	uint8_t rowSize = getRowSize();
+
+	while (count) {
+		uint8_t row[32];
+		uint16_t rowAddress = address & ~(uint16_t)(rowSize - 1);
+		uint8_t offset = address - rowAddress;
+		uint8_t length = ((uint16_t)(rowSize - offset) < count) ? (rowSize - offset) : count;
+
+		/* A partial row is read first, so that the bytes around the new ones are programmed back unchanged */
+		if (length != rowSize) {
+			uint8_t result = read(rowAddress, row, rowSize);
+
+			if (result != ONEWIRE_EEPROM_OK) {
+				return result;
+			}
+		}
+
+		for (uint8_t i = 0; i < length; i++) {
+			row[offset + i] = data[i];
+		}
+
+		uint8_t result = writeRow(rowAddress, row);
+
+		if (result != ONEWIRE_EEPROM_OK) {
+			return result;
+		}
+
+		address += length;
+		data += length;
+		count -= length;
+	}
+
+	return ONEWIRE_EEPROM_OK;
+}
+
+
+/**
+ * The CRC16 the device answers with covers the command, the target address and the data, in that order.
+ */
+uint8_t OneWireEEPROM::writeScratchpad(uint16_t address, const uint8_t *data) {
+	OneWireLock guard(mBus);
+	uint8_t length = getRowSize() - (address & (getRowSize() - 1));
+	uint8_t command[3] = { WIRE_COMMAND_EEPROM_WRITE_SCRATCHPAD, (uint8_t)address, (uint8_t)(address >> 8) };
+	uint8_t crc[2];
+
+	if (!select()) {
+		return ONEWIRE_EEPROM_NO_PRESENCE;
+	}
+
+	mBus.wireWriteBytes(command, 3);
+	mBus.wireWriteBytes(data, length);
+	mBus.wireReadBytes(crc, 2);
+
+	deselect();
+
+	if (!OneWire::check_crc16(data, length, crc, OneWire::crc16(command, 3))) {
+		mBus.noteCrcError();
+		return ONEWIRE_EEPROM_CRC;
+	}
+
+	return ONEWIRE_EEPROM_OK;
+}
+
+
+uint8_t OneWireEEPROM::readScratchpad(uint16_t *address, uint8_t *es, uint8_t *data) {
+	OneWireLock guard(mBus);
+	uint8_t mask = getRowSize() - 1;
+	uint8_t header[3];
+	uint8_t crc[2];
+
+	if (!select()) {
+		return ONEWIRE_EEPROM_NO_PRESENCE;
+	}
+
+	mBus.wireWriteByte(WIRE_COMMAND_EEPROM_READ_SCRATCHPAD);
+	uint16_t sum = mBus.wireReadBytesCrc16(header, 3, OneWire::crc16Update(0, WIRE_COMMAND_EEPROM_READ_SCRATCHPAD));
+
+	/* The data runs from the target address's offset through the ending offset in the E/S register */
+	uint8_t first = header[0] & mask;
+	uint8_t last = header[2] & mask;
+	uint8_t length = (last >= first) ? (last - first + 1) : 0;
+
+	sum = mBus.wireReadBytesCrc16(data, length, sum);
+	mBus.wireReadBytes(crc, 2);
+
+	deselect();
+
+	if (!OneWire::check_crc16(crc, 0, crc, sum)) {
+		mBus.noteCrcError();
+		return ONEWIRE_EEPROM_CRC;
+	}
+
+	*address = header[0] | ((uint16_t)header[1] << 8);
+	*es = header[2];
+
+	return ONEWIRE_EEPROM_OK;
+}
+
+
+/**
+ * On a parasitically powered bus, the E/S byte goes out with the strong pullup armed, and the pullup is held through
+ * tPROG. Otherwise, the bus just sits idle for tPROG once the byte is done.
+ */
+uint8_t OneWireEEPROM::copyScratchpad(uint16_t address, uint8_t es) {
+	OneWireLock guard(mBus);
+	uint8_t command[3] = { WIRE_COMMAND_EEPROM_COPY_SCRATCHPAD, (uint8_t)address, (uint8_t)(address >> 8) };
+
+	if (!select()) {
+		return ONEWIRE_EEPROM_NO_PRESENCE;
+	}
+
+	mBus.wireWriteBytes(command, 3);
+
+	if (mParasite && mBus.startStrongPullup(es, ONEWIRE_EEPROM_PROGRAM_TIME)) {
+		while (mBus.pollStrongPullup()) {
+			mBus.pause(mBus.strongPullupRemaining());
+		}
+	} else {
+		mBus.wireWriteBytes(&es, 1);
+		mBus.pause(mBus.busyTimeRemaining() + ONEWIRE_EEPROM_PROGRAM_TIME);
+	}
+
+	uint8_t confirmation = mBus.wireReadByte();
+
+	deselect();
+
+	return (confirmation == ONEWIRE_EEPROM_COPY_DONE) ? ONEWIRE_EEPROM_OK : ONEWIRE_EEPROM_COPY;
+}
+
+
+/**
+ * The scratchpad is read back before the copy: the authorization pattern the copy needs is the target address and
+ * E/S register as the device reports them, and a full, unflagged row which matches the data is the only proof that
+ * nothing was lost on the way in.
+ */
+uint8_t OneWireEEPROM::writeRow(uint16_t address, const uint8_t *row) {
+	uint8_t rowSize = getRowSize();
+	uint8_t readBack[32];
+	uint16_t target;
+	uint8_t es;
+	uint8_t result;
+
+	result = writeScratchpad(address, row);
+	if (result != ONEWIRE_EEPROM_OK) {
+		return result;
+	}
+
+	result = readScratchpad(&target, &es, readBack);
+	if (result != ONEWIRE_EEPROM_OK) {
+		return result;
+	}
+
+	if (target != address || (es & ONEWIRE_EEPROM_ES_PF) || (es & (rowSize - 1)) != rowSize - 1) {
+		return ONEWIRE_EEPROM_VERIFY;
+	}
+
+	for (uint8_t i = 0; i < rowSize; i++) {
+		if (readBack[i] != row[i]) {
+			return ONEWIRE_EEPROM_VERIFY;
+		}
+	}
+
+	return copyScratchpad(target, es);
+}
+
+
+/**
+ * Overdrive Match ROM needs the bus at standard speed for the reset and the ROM command; the bridge is switched to
+ * overdrive by wireOverdriveSelect() itself. If the bridge already runs at overdrive, the device is taken to already
+ * be there as well, and a plain Match ROM at that speed does.
+ */
+uint8_t OneWireEEPROM::select() {
+	mBusOverdrive = mBus.isOverdrive();
+
+	if (mOverdrive && !mBusOverdrive) {
+		if (!mBus.wireReset()) {
+			return false;
+		}
+		mBus.wireOverdriveSelect(mRom);
+		return true;
+	}
+
+	if (!mBus.wireReset()) {
+		return false;
+	}
+	mBus.wireSelect(mRom);
+
+	return true;
+}
+
+
+void OneWireEEPROM::deselect() {
+	if (mBus.isOverdrive() != mBusOverdrive) {
+		mBus.setOverdrive(mBusOverdrive);
+	}
+}
@@ -0,0 +1,190 @@
+/**
+ * \file OneWireEEPROM.h
+ * Provides page-level access to DS2431 and DS28EC20 1-Wire EEPROMs: streamed memory reads over any range, and writes
+ * which go through the scratchpad a whole row at a time, verified with the devices' CRC16.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREEEPROM_H__
+#define _DS2482OW__SRC_ONEWIREEEPROM_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup eepromDefinitions	EEPROM families, commands and results.
+ * @{
+ */
+#define ONEWIRE_FAMILY_DS2431			0x2D	/*! Family code of the DS2431 1024-bit EEPROM */
+#define ONEWIRE_FAMILY_DS28EC20			0x43	/*! Family code of the DS28EC20 20kbit EEPROM */
+
+#define WIRE_COMMAND_EEPROM_WRITE_SCRATCHPAD	0x0F	/*! The EEPROM function command to write the scratchpad */
+#define WIRE_COMMAND_EEPROM_READ_SCRATCHPAD		0xAA	/*! The EEPROM function command to read the scratchpad */
+#define WIRE_COMMAND_EEPROM_COPY_SCRATCHPAD		0x55	/*! The EEPROM function command to copy the scratchpad */
+#define WIRE_COMMAND_EEPROM_READ_MEMORY			0xF0	/*! The EEPROM function command to read memory */
+
+#define ONEWIRE_EEPROM_COPY_DONE		0xAA	/*! The pattern a device answers read slots with after a successful copy */
+#define ONEWIRE_EEPROM_ES_AA			(1<<7)	/*! E/S register: authorization accepted, the copy has been done */
+#define ONEWIRE_EEPROM_ES_PF			(1<<5)	/*! E/S register: partial byte flag, the scratchpad write was incomplete */
+
+/**
+ * \def ONEWIRE_EEPROM_PROGRAM_TIME	tPROG, the time a Copy Scratchpad takes to program a row, in microseconds.
+ */
+#ifndef ONEWIRE_EEPROM_PROGRAM_TIME
+#define ONEWIRE_EEPROM_PROGRAM_TIME		10000
+#endif
+
+#define ONEWIRE_EEPROM_OK				0	/*! The operation succeeded */
+#define ONEWIRE_EEPROM_NO_PRESENCE		1	/*! No device answered the reset */
+#define ONEWIRE_EEPROM_CRC				2	/*! A CRC16 sent by the device did not check out */
+#define ONEWIRE_EEPROM_VERIFY			3	/*! The scratchpad did not read back as written */
+#define ONEWIRE_EEPROM_COPY				4	/*! The device did not confirm the copy (e.g. the row is write protected) */
+#define ONEWIRE_EEPROM_RANGE			5	/*! The address range is outside of what the function may access */
+/**
+ * @}
+ */
+
+
+/**
+ * \class OneWireEEPROM	Reads and writes the memory of a DS2431 or DS28EC20.
+ *
+ * read() streams any range of memory with a single Read Memory command. write() splits its range into scratchpad
+ * rows (8 bytes on a DS2431, 32 on a DS28EC20); rows which are only partly written are read first, so that the rest
+ * of the row is kept. Each row is written to the scratchpad, checked against the CRC16 the device returns, read
+ * back and compared, and then copied to memory, waiting tPROG (under the strong pullup on parasitically powered
+ * buses) before the device's confirmation is checked.
+ *
+ * With setOverdrive(), every transaction selects the device with Overdrive Match ROM, so that everything after the
+ * ROM command runs at overdrive speed; the bridge is put back to the speed it was at afterwards.
+ * \code{.cpp}
+ * OneWireEEPROM eeprom(oneWire, rom);
+ * eeprom.setOverdrive(1);
+ * if (eeprom.write(0x00, calibration, sizeof(calibration)) == ONEWIRE_EEPROM_OK) {
+ *     ...
+ * }
+ * \endcode
+ */
+class OneWireEEPROM {
+public:
+	/**
+	 * \param[in]	bus	The bus the device is on.
+	 * \param[in]	rom	The ROM of the device; its family code selects the memory layout.
+	 */
+	OneWireEEPROM(OneWire &bus, const uint8_t rom[8]);
+
+	/**
+	 * \param[in]	overdrive	1 to talk to the device at overdrive speed, 0 to stay at standard speed.
+	 */
+	void setOverdrive(uint8_t overdrive);
+
+	/**
+	 * \param[in]	parasite	1 if the device is parasitically powered, so that it needs the strong pullup while a
+	 *							row is programmed.
+	 */
+	void setParasite(uint8_t parasite);
+
+	/**
+	 * \return	The size of the memory, in bytes, not counting the register pages behind it.
+	 */
+	uint16_t getSize();
+
+	/**
+	 * \return	The size of the address space, in bytes, register pages included.
+	 */
+	uint16_t getAddressSpace();
+
+	/**
+	 * \return	The size of the scratchpad, in bytes; rows are programmed in units of this size.
+	 */
+	uint8_t getRowSize();
+
+	/**
+	 * Reads a range of memory, register pages included, in a single stream.
+	 *
+	 * \param[in]	address	The address to start at.
+	 * \param[out]	buf		The buffer to read into.
+	 * \param[in]	count	The number of bytes to read.
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results.
+	 */
+	uint8_t read(uint16_t address, uint8_t *buf, uint16_t count);
+
+	/**
+	 * Writes a range of the data memory, a scratchpad row at a time. The range must lie within the first getSize()
+	 * bytes: the register pages behind them can only be written with writeRegisters().
+	 *
+	 * \param[in]	address	The address to start at.
+	 * \param[in]	data	The bytes to write.
+	 * \param[in]	count	The number of bytes to write.
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results; rows before the one which failed have been written.
+	 */
+	uint8_t write(uint16_t address, const uint8_t *data, uint16_t count);
+
+	/**
+	 * Writes a range of the register pages (0x80 to 0x8F on a DS2431, 0xA00 to 0xA1F on a DS28EC20), in the same way
+	 * as write().
+	 *
+	 * \warning	These are the page protection and control registers: writing the wrong value to one of them can make
+	 *			memory pages, or the registers themselves, permanently read-only.
+	 *
+	 * \param[in]	address	The address to start at; getSize() or above.
+	 * \param[in]	data	The bytes to write.
+	 * \param[in]	count	The number of bytes to write.
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results; rows before the one which failed have been written.
+	 */
+	uint8_t writeRegisters(uint16_t address, const uint8_t *data, uint16_t count);
+
+	/**
+	 * Writes to the scratchpad, from a target address to the end of its row, and checks the CRC16 the device answers
+	 * with.
+	 *
+	 * \param[in]	address	The target address.
+	 * \param[in]	data	The bytes to write; as many as are left in the row from the target address.
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results.
+	 */
+	uint8_t writeScratchpad(uint16_t address, const uint8_t *data);
+
+	/**
+	 * Reads the scratchpad, along with its target address and E/S register, and checks its CRC16. The device sends
+	 * the scratchpad from the target address's offset through the ending offset; for a row written by write(), that
+	 * is the whole row.
+	 *
+	 * \param[out]	address	Receives the target address.
+	 * \param[out]	es		Receives the E/S (ending offset and status) register.
+	 * \param[out]	data	Receives the scratchpad bytes; room for getRowSize() bytes is needed.
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results.
+	 */
+	uint8_t readScratchpad(uint16_t *address, uint8_t *es, uint8_t *data);
+
+	/**
+	 * Copies the scratchpad to memory, waits for the row to be programmed, and checks the device's confirmation.
+	 *
+	 * \param[in]	address	The target address, as read back with readScratchpad().
+	 * \param[in]	es		The E/S register, as read back with readScratchpad().
+	 *
+	 * \return	One of the ONEWIRE_EEPROM_ results.
+	 */
+	uint8_t copyScratchpad(uint16_t address, uint8_t es);
+
+private:
+	uint8_t select();
+	void deselect();
+	uint8_t writeRange(uint16_t address, const uint8_t *data, uint16_t count);
+	uint8_t writeRow(uint16_t address, const uint8_t *row);
+
+	OneWire &mBus;
+	uint8_t mRom[8];
+	uint8_t mOverdrive;
+	uint8_t mParasite;
+	uint8_t mBusOverdrive;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREEEPROM_H__ */
@@ -6,55 +6,44 @@
  * \note	See README.md for any additional author/copyright info.
  */
 
+#include <Arduino.h>
 #include "OneWireExtraHelpers.h"
 
-#ifdef USE_DALLASTEMPERATURE_LIBRARY
-#include <DallasTemperature.h>
 
-void OneWireHelpersClass::printDeviceAddress(uint8_t devAddr[8]) {
-	Serial.print("{ ");
+/**
+ * \var hexDigits	The digits each octet is formatted with; uppercase, as \c Serial.print(value, HEX) would print them.
+ */
+static const char hexDigits[] = "0123456789ABCDEF";
 
-	for (uint8_t i = 0; i < 8; i++) {
-		/* Print "0x" hexadecimal prefix */
-		Serial.print("0x");
 
-		/* Pad printed value with a zero if the value is less than 16; this ensures consistent 2-digit octets */
-		if (devAddr[i] < 16) {
-			Serial.print("0");
-		}
+char *OneWireHelpersClass::formatDeviceAddress(const uint8_t devAddr[8], char *buf) {
+	char *out = buf;
 
-		/* Print value as hexadecimal */
-		Serial.print(devAddr[i], HEX);
+	*out++ = '{';
+	*out++ = ' ';
+
+	for (uint8_t i = 0; i < 8; i++) {
+		/* Every octet gets the "0x" prefix and two digits, so that the string always has the same length */
+		*out++ = '0';
+		*out++ = 'x';
+		*out++ = hexDigits[devAddr[i] >> 4];
+		*out++ = hexDigits[devAddr[i] & 0x0F];
 		if (i < 7) {
-			Serial.print(", ");
+			*out++ = ',';
+			*out++ = ' ';
 		}
 	}
 
-	Serial.print(" }");
-}
-#endif
-
+	*out++ = ' ';
+	*out++ = '}';
+	*out = '\0';
 
-#ifdef USE_DALLASTEMPERATURE_LIBRARY
-void OneWireHelpersClass::printDeviceAddress(DeviceAddress devAddr) {
-	Serial.print("{ ");
-
-	for (uint8_t i = 0; i < 8; i++) {
-		/* Print "0x" hexadecimal prefix */
-		Serial.print("0x");
+	return buf;
+}
 
-		/* Pad printed value with a zero if the value is less than 16; this ensures consistent 2-digit octets */
-		if (devAddr[i] < 16) {
-			Serial.print("0");
-		}
 
-		/* Print value as hexadecimal */
-		Serial.print(devAddr[i], HEX);
-		if (i < 7) {
-			Serial.print(", ");
-		}
-	}
+void OneWireHelpersClass::printDeviceAddress(const uint8_t devAddr[8]) {
+	char buf[ONEWIRE_ADDRESS_STRING_SIZE];
 
-	Serial.print(" }");
+	Serial.print(formatDeviceAddress(devAddr, buf));
 }
-#endif
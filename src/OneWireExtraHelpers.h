@@ -16,26 +16,34 @@
 
 #endif
 
+/**
+ * \def ONEWIRE_ADDRESS_STRING_SIZE	The size of the buffer formatDeviceAddress() needs, terminating NUL included:
+ *									"{ 0x28, 0xFF, 0x4B, 0x1A, 0x61, 0x16, 0x04, 0x9C }".
+ */
+#define ONEWIRE_ADDRESS_STRING_SIZE		51
+
+
 class OneWireHelpersClass {
 public:
 	/**
-	 * \fn printDeviceAddress	Provides a function to print a 1-Wire device's serial number to the serial console, as a
-	 *							nicely formatted string.
+	 * \fn formatDeviceAddress	Formats a 1-Wire device's serial number into a caller-provided buffer, as the same
+	 *							nicely formatted string printDeviceAddress() prints, in a single pass.
 	 *
 	 * \param[in]	devAddr	An array of 8 unsigned byte values which represent the device's serial number.
+	 * \param[out]	buf		The buffer to format into; at least ONEWIRE_ADDRESS_STRING_SIZE bytes.
+	 *
+	 * \return	The buffer, for convenience.
 	 */
-	void printDeviceAddress(uint8_t devAddr[8]);
+	static char *formatDeviceAddress(const uint8_t devAddr[8], char *buf);
 
-#ifdef USE_DALLASTEMPERATURE_LIBRARY
 	/**
 	 * \fn printDeviceAddress	Provides a function to print a 1-Wire device's serial number to the serial console, as a
-	 *							nicely formatted string.
+	 *							nicely formatted string. The string is formatted first, and printed with a single call.
 	 *
-	 * \param[in]	devAddr	The 64-bit serial number of the 1-Wire device, stored in a DeviceAddress object, which is
-	 *						provided by the DallasTemperature library.
+	 * \param[in]	devAddr	An array of 8 unsigned byte values which represent the device's serial number. The
+	 *						\c DeviceAddress type of the DallasTemperature library is such an array, too.
 	 */
-	void printDeviceAddress(DeviceAddress devAddr);
-#endif
+	void printDeviceAddress(const uint8_t devAddr[8]);
 };
 
 
@@ -0,0 +1,204 @@
+/**
+ * \file OneWireInventory.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireInventory.h"
+
+
+OneWireInventory::OneWireInventory(OneWire &bus, OneWireInventoryEntry *entries, uint8_t capacity) :
+		mBus(bus), mEntries(entries), mCapacity(capacity) {
+	mCount = 0;
+	mBus.wireResetSearch(mSearch);
+}
+
+
+uint8_t OneWireInventory::discover() {
+	uint8_t rom[8];
+	uint8_t found = 0;
+
+	for (uint8_t d = 0; d < mCount; d++) {
+		mEntries[d].flags = 0;
+	}
+
+	mBus.wireResetSearch(mSearch);
+	while (mBus.wireSearch(rom, mSearch)) {
+		if (OneWire::crc8(rom, 7) != rom[7]) {
+			mBus.noteCrcError();
+			continue;
+		}
+
+		uint8_t index = indexOf(rom);
+		if (index == 0xFF) {
+			if (mCount >= mCapacity) {
+				continue;
+			}
+			index = mCount++;
+			for (uint8_t i = 0; i < 8; i++) {
+				mEntries[index].rom[i] = rom[i];
+			}
+			mEntries[index].flags = ONEWIRE_DEVICE_NEW;
+		}
+
+		mEntries[index].flags |= ONEWIRE_DEVICE_PRESENT;
+		found++;
+	}
+
+	return found;
+}
+
+
+uint8_t OneWireInventory::verify() {
+	uint8_t present = 0;
+
+	for (uint8_t d = 0; d < mCount; d++) {
+		if (mBus.wireVerify(mEntries[d].rom)) {
+			mEntries[d].flags |= ONEWIRE_DEVICE_PRESENT;
+			present++;
+		} else {
+			mEntries[d].flags &= ~ONEWIRE_DEVICE_PRESENT;
+		}
+	}
+
+	return present;
+}
+
+
+uint8_t OneWireInventory::refresh() {
+	uint8_t present = 0;
+
+	discover();
+
+	for (uint8_t d = 0; d < mCount; d++) {
+		if (mEntries[d].flags & ONEWIRE_DEVICE_PRESENT) {
+			present++;
+		}
+	}
+
+	return present;
+}
+
+
+void OneWireInventory::prune() {
+	uint8_t kept = 0;
+
+	for (uint8_t d = 0; d < mCount; d++) {
+		if (mEntries[d].flags & ONEWIRE_DEVICE_PRESENT) {
+			if (kept != d) {
+				mEntries[kept] = mEntries[d];
+			}
+			kept++;
+		}
+	}
+
+	mCount = kept;
+}
+
+
+void OneWireInventory::clear() {
+	mCount = 0;
+}
+
+
+uint8_t OneWireInventory::getCount() {
+	return mCount;
+}
+
+
+OneWireInventoryEntry &OneWireInventory::getEntry(uint8_t index) {
+	return mEntries[index];
+}
+
+
+uint8_t OneWireInventory::indexOf(const uint8_t rom[8]) {
+	for (uint8_t d = 0; d < mCount; d++) {
+		uint8_t i = 0;
+		while (i < 8 && mEntries[d].rom[i] == rom[i]) {
+			i++;
+		}
+		if (i == 8) {
+			return d;
+		}
+	}
+
+	return 0xFF;
+}
+
+
+uint16_t OneWireInventory::getStoredSize() {
+	return ONEWIRE_INVENTORY_HEADER_SIZE + mCount * 8;
+}
+
+
+uint16_t OneWireInventory::save(uint8_t *buf, uint16_t size) {
+	uint16_t stored = getStoredSize();
+	uint8_t crc = 0;
+
+	if (size < stored) {
+		return 0;
+	}
+
+	for (uint16_t i = 0; i < stored - 1; i++) {
+		buf[i] = storedByte(i);
+		crc = OneWire::crc8Update(crc, buf[i]);
+	}
+	buf[stored - 1] = crc;
+
+	return stored;
+}
+
+
+uint8_t OneWireInventory::load(const uint8_t *buf, uint16_t size) {
+	if (size < ONEWIRE_INVENTORY_HEADER_SIZE || ((buf[0] << 8) | buf[1]) != ONEWIRE_INVENTORY_MAGIC) {
+		return 0;
+	}
+
+	uint8_t count = buf[2];
+	uint16_t stored = ONEWIRE_INVENTORY_HEADER_SIZE + count * 8;
+	if (count > mCapacity || size < stored) {
+		return 0;
+	}
+
+	uint8_t crc = 0;
+	for (uint16_t i = 0; i < stored - 1; i++) {
+		crc = OneWire::crc8Update(crc, buf[i]);
+	}
+	if (crc != buf[stored - 1]) {
+		return 0;
+	}
+
+	for (uint8_t d = 0; d < count; d++) {
+		for (uint8_t i = 0; i < 8; i++) {
+			mEntries[d].rom[i] = buf[ONEWIRE_INVENTORY_HEADER_SIZE - 1 + d * 8 + i];
+		}
+		mEntries[d].flags = 0;
+	}
+	mCount = count;
+
+	return count;
+}
+
+
+/**
+ * Returns a byte of the stored format, without the trailing CRC: the magic (high byte first), the device count and
+ * the ROMs of the devices.
+ */
+uint8_t OneWireInventory::storedByte(uint16_t offset) {
+	switch (offset) {
+		case 0:
+			return ONEWIRE_INVENTORY_MAGIC >> 8;
+		case 1:
+			return ONEWIRE_INVENTORY_MAGIC & 0xFF;
+		case 2:
+			return mCount;
+		default:
+			offset -= ONEWIRE_INVENTORY_HEADER_SIZE - 1;
+			return mEntries[offset / 8].rom[offset % 8];
+	}
+}
+
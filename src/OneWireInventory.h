@@ -0,0 +1,229 @@
+/**
+ * \file OneWireInventory.h
+ * Provides a persistent inventory of the devices on a 1-Wire bus, which can be saved and restored so that a known bus
+ * is usable straight after boot, without waiting for a search.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREINVENTORY_H__
+#define _DS2482OW__SRC_ONEWIREINVENTORY_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup inventoryDefinitions	Inventory entry flags and storage format.
+ * @{
+ */
+#define ONEWIRE_DEVICE_PRESENT			(1<<0)	/*! The device was found by the last discovery or verification */
+#define ONEWIRE_DEVICE_NEW				(1<<1)	/*! The device was first found by the last discovery */
+
+#define ONEWIRE_INVENTORY_MAGIC			0x4F57	/*! Marks a stored inventory ("OW") */
+#define ONEWIRE_INVENTORY_HEADER_SIZE	4		/*! Magic (2 bytes), device count and CRC8 */
+/**
+ * @}
+ */
+
+
+/**
+ * \struct OneWireInventoryEntry	One device of the inventory. An array of these is provided by the caller.
+ */
+struct OneWireInventoryEntry {
+	uint8_t rom[8];		/*!< The ROM of the device */
+	uint8_t flags;		/*!< A combination of the ONEWIRE_DEVICE_ flags */
+};
+
+
+/**
+ * \class OneWireInventory	Keeps track of the devices on a bus.
+ *
+ * discover() runs a full search, keeping the devices already known, flagging the ones which are new and clearing the
+ * present flag of the ones which were not found. verify() checks the known devices one at a time with wireVerify()
+ * instead; this is not cheaper than a search: every device which is present still takes a pass of 64 triplets, just
+ * as it does in a search, so verifying a whole bus costs as much as discovering it. It is meant for checking a few
+ * devices of interest, not for keeping the whole inventory up to date, which is what refresh() (a discovery) does.
+ *
+ * What the inventory does save is the search at boot: it can be saved to, and restored from, a byte buffer or any
+ * EEPROM-like object, so that a known bus is available straight away, and the search can be run later, when there is
+ * time for it:
+ * \code{.cpp}
+ * #include <EEPROM.h>
+ * ...
+ * if (!inventory.loadFrom(EEPROM, 0)) {
+ *     inventory.discover();
+ *     inventory.saveTo(EEPROM, 0);
+ * }
+ * \endcode
+ */
+class OneWireInventory {
+public:
+	/**
+	 * \param[in]	bus			The bus the devices are on.
+	 * \param[in]	entries		Caller-provided storage for the inventory.
+	 * \param[in]	capacity	The number of entries the storage has room for.
+	 */
+	OneWireInventory(OneWire &bus, OneWireInventoryEntry *entries, uint8_t capacity);
+
+	/**
+	 * Searches the whole bus. Devices already in the inventory are marked present, devices which are not yet in it are
+	 * added and marked present and new, and devices which were not found are kept, but marked not present. ROMs with
+	 * a bad CRC are ignored.
+	 *
+	 * \return	The number of devices found.
+	 */
+	uint8_t discover();
+
+	/**
+	 * Checks every device in the inventory individually, updating its present flag. This takes 64 triplets for every
+	 * device which is present, the same as discover() takes, and stops early only on the devices which are missing.
+	 *
+	 * \return	The number of devices which are present.
+	 */
+	uint8_t verify();
+
+	/**
+	 * Brings the inventory up to date with a single full discovery, which finds devices which have been added as well
+	 * as those which have gone missing. Verifying the known devices first would cost as much as the discovery itself,
+	 * so it is not done.
+	 *
+	 * \return	The number of devices which are present.
+	 */
+	uint8_t refresh();
+
+	/**
+	 * Removes every device which is not present from the inventory.
+	 */
+	void prune();
+
+	/**
+	 * Removes all devices from the inventory.
+	 */
+	void clear();
+
+	/**
+	 * \return	The number of devices in the inventory.
+	 */
+	uint8_t getCount();
+
+	/**
+	 * \param[in]	index	The index of the device.
+	 *
+	 * \return	The inventory entry of the device.
+	 */
+	OneWireInventoryEntry &getEntry(uint8_t index);
+
+	/**
+	 * \param[in]	rom	A ROM to look for.
+	 *
+	 * \return	The index of the device with that ROM, or 0xFF if it is not in the inventory.
+	 */
+	uint8_t indexOf(const uint8_t rom[8]);
+
+	/**
+	 * \return	The number of bytes save() needs to store the inventory.
+	 */
+	uint16_t getStoredSize();
+
+	/**
+	 * Serializes the ROMs of the inventory into a buffer, followed by a CRC8.
+	 *
+	 * \param[out]	buf		The buffer to write to.
+	 * \param[in]	size	The size of the buffer.
+	 *
+	 * \return	The number of bytes written, or 0 if the buffer is too small.
+	 */
+	uint16_t save(uint8_t *buf, uint16_t size);
+
+	/**
+	 * Restores the inventory from a buffer written by save(). Restored devices are not marked present until they have
+	 * been verified.
+	 *
+	 * \param[in]	buf		The buffer to read from.
+	 * \param[in]	size	The size of the buffer.
+	 *
+	 * \return	The number of devices restored; 0 if the buffer does not hold a valid inventory.
+	 */
+	uint8_t load(const uint8_t *buf, uint16_t size);
+
+	/**
+	 * Saves the inventory to an EEPROM-like object, such as the Arduino \c EEPROM, which provides \c read(int) and
+	 * \c write(int, uint8_t). On platforms which emulate EEPROM in flash (ESP8266, ESP32), \c EEPROM.commit() must still
+	 * be called afterwards.
+	 *
+	 * \param[in]	storage	The storage object.
+	 * \param[in]	address	The address to save to.
+	 *
+	 * \return	The number of bytes written.
+	 */
+	template <class Storage> uint16_t saveTo(Storage &storage, int address) {
+		uint8_t crc = 0;
+		uint16_t size = getStoredSize();
+
+		for (uint16_t i = 0; i < size - 1; i++) {
+			uint8_t b = storedByte(i);
+			storage.write(address + i, b);
+			crc = OneWire::crc8Update(crc, b);
+		}
+		storage.write(address + size - 1, crc);
+
+		return size;
+	}
+
+	/**
+	 * Restores the inventory from an EEPROM-like object, which provides \c read(int). The stored image is checked
+	 * against its CRC8 before anything is restored, so a corrupt image leaves the inventory as it was.
+	 *
+	 * \param[in]	storage	The storage object.
+	 * \param[in]	address	The address to restore from.
+	 *
+	 * \return	The number of devices restored; 0 if the storage does not hold a valid inventory.
+	 */
+	template <class Storage> uint8_t loadFrom(Storage &storage, int address) {
+		uint8_t header[ONEWIRE_INVENTORY_HEADER_SIZE - 1];
+		uint8_t crc = 0;
+
+		for (uint8_t i = 0; i < sizeof(header); i++) {
+			header[i] = storage.read(address + i);
+			crc = OneWire::crc8Update(crc, header[i]);
+		}
+		if (((header[0] << 8) | header[1]) != ONEWIRE_INVENTORY_MAGIC || header[2] > mCapacity) {
+			return 0;
+		}
+
+		/* A first pass only checks the CRC8, so that the entries are not touched unless the image is valid */
+		uint8_t count = header[2];
+		uint16_t romBytes = count * 8;
+		for (uint16_t i = 0; i < romBytes; i++) {
+			crc = OneWire::crc8Update(crc, storage.read(address + sizeof(header) + i));
+		}
+		if (storage.read(address + sizeof(header) + romBytes) != crc) {
+			return 0;
+		}
+
+		for (uint8_t d = 0; d < count; d++) {
+			for (uint8_t i = 0; i < 8; i++) {
+				mEntries[d].rom[i] = storage.read(address + sizeof(header) + d * 8 + i);
+			}
+			mEntries[d].flags = 0;
+		}
+
+		mCount = count;
+		return count;
+	}
+
+private:
+	uint8_t storedByte(uint16_t offset);
+
+	OneWire &mBus;
+	OneWireInventoryEntry *mEntries;
+	uint8_t mCapacity;
+	uint8_t mCount;
+
+	OneWireSearchState mSearch;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREINVENTORY_H__ */
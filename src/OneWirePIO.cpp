@@ -0,0 +1,156 @@
+/**
+ * \file OneWirePIO.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWirePIO.h"
+
+
+OneWirePIO::OneWirePIO(OneWire &bus) : mBus(bus) {
+	mFamily = 0;
+	mCommand = 0;
+	mFirstBlock = 0;
+}
+
+
+uint8_t OneWirePIO::beginWrite(const uint8_t rom[8]) {
+	return begin(rom, WIRE_COMMAND_PIO_WRITE);
+}
+
+
+uint8_t OneWirePIO::beginRead(const uint8_t rom[8]) {
+	mFirstBlock = 1;
+	return begin(rom, WIRE_COMMAND_PIO_READ);
+}
+
+
+uint8_t OneWirePIO::begin(const uint8_t rom[8], uint8_t command) {
+	mCommand = 0;
+	mFamily = rom[0];
+
+	if (!mBus.wireReset()) {
+		return false;
+	}
+
+	mBus.wireSelect(rom);
+	mBus.wireWriteBytes(&command, 1);
+	mCommand = command;
+
+	return true;
+}
+
+
+/**
+ * The state and its inverse go out as two timed writes, and the confirmation and pin states come back as two streamed
+ * reads, each checked with a single status read: eleven I2C transactions in the normal case, against sixteen for the
+ * same bytes sent and read one at a time.
+ */
+uint8_t OneWirePIO::write(uint8_t state, uint8_t *pins) {
+	if (mCommand != WIRE_COMMAND_PIO_WRITE) {
+		return false;
+	}
+
+	/* The DS2413 only has two outputs; the other bits of the state byte must be written as 1 */
+	if (mFamily == ONEWIRE_FAMILY_DS2413) {
+		state |= 0xFC;
+	}
+
+	uint8_t out[2] = { state, (uint8_t)~state };
+	uint8_t in[2];
+
+	mBus.wireWriteBytes(out, 2);
+	mBus.wireStreamBytes(in, 2);
+
+	/* A DS2413's status byte carries its own complement in the upper nibble, as its read samples do */
+	if (in[0] != ONEWIRE_PIO_CONFIRM ||
+			(mFamily == ONEWIRE_FAMILY_DS2413 && (in[1] >> 4) != (uint8_t)(~in[1] & 0x0F))) {
+		mCommand = 0;
+		return false;
+	}
+
+	if (pins) {
+		*pins = (mFamily == ONEWIRE_FAMILY_DS2413) ? (in[1] & 0x0F) : in[1];
+	}
+
+	return true;
+}
+
+
+uint16_t OneWirePIO::write(const uint8_t *states, uint16_t count, uint8_t *pins) {
+	for (uint16_t i = 0; i < count; i++) {
+		if (!write(states[i], pins ? &pins[i] : 0)) {
+			return i;
+		}
+	}
+
+	return count;
+}
+
+
+uint16_t OneWirePIO::read(uint8_t *samples, uint16_t count) {
+	if (mCommand != WIRE_COMMAND_PIO_READ) {
+		return 0;
+	}
+
+	if (mFamily == ONEWIRE_FAMILY_DS2413) {
+		for (uint16_t i = 0; i < count; i++) {
+			uint8_t sample;
+
+			mBus.wireStreamBytes(&sample, 1);
+
+			/* The upper nibble is the complement of the status nibble */
+			if ((sample >> 4) != (uint8_t)(~sample & 0x0F)) {
+				mCommand = 0;
+				return i;
+			}
+			samples[i] = sample & 0x0F;
+		}
+
+		return count;
+	}
+
+	uint16_t verified = 0;
+
+	while (verified < count) {
+		uint8_t block[ONEWIRE_PIO_BLOCK + 2];
+		uint16_t wanted = count - verified;
+		uint8_t *dest = (wanted >= ONEWIRE_PIO_BLOCK) ? samples + verified : block;
+		uint16_t crc = 0;
+
+		if (mFirstBlock) {
+			crc = OneWire::crc16Update(crc, WIRE_COMMAND_PIO_READ);
+			mFirstBlock = 0;
+		}
+
+		/* Every block is read whole, straight into the caller's buffer unless it is the partial last one */
+		crc = mBus.wireReadBytesCrc16(dest, ONEWIRE_PIO_BLOCK, crc);
+		mBus.wireStreamBytes(block + ONEWIRE_PIO_BLOCK, 2);
+
+		if (!OneWire::check_crc16(dest, 0, block + ONEWIRE_PIO_BLOCK, crc)) {
+			mBus.noteCrcError();
+			mCommand = 0;
+			return verified;
+		}
+
+		if (dest == block) {
+			for (uint16_t i = 0; i < wanted; i++) {
+				samples[verified + i] = block[i];
+			}
+			verified += wanted;
+		} else {
+			verified += ONEWIRE_PIO_BLOCK;
+		}
+	}
+
+	return verified;
+}
+
+
+uint8_t OneWirePIO::isStreaming() {
+	return mCommand ? true : false;
+}
@@ -0,0 +1,136 @@
+/**
+ * \file OneWirePIO.h
+ * Provides streaming access to the PIO pins of DS2408 and DS2413 addressable switches: the device is selected once,
+ * after which state bytes are written or sampled back to back, each one verified as it comes in.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREPIO_H__
+#define _DS2482OW__SRC_ONEWIREPIO_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup pioDefinitions	Switch families and commands.
+ * @{
+ */
+#define ONEWIRE_FAMILY_DS2408			0x29	/*! Family code of the DS2408 8-channel addressable switch */
+#define ONEWIRE_FAMILY_DS2413			0x3A	/*! Family code of the DS2413 dual-channel addressable switch */
+
+#define WIRE_COMMAND_PIO_WRITE			0x5A	/*! Channel-Access Write (DS2408) / PIO Access Write (DS2413) */
+#define WIRE_COMMAND_PIO_READ			0xF5	/*! Channel-Access Read (DS2408) / PIO Access Read (DS2413) */
+
+#define ONEWIRE_PIO_CONFIRM				0xAA	/*! The byte a switch confirms a PIO write with */
+#define ONEWIRE_PIO_BLOCK				32		/*! Samples per CRC16-protected block of a DS2408 Channel-Access Read */
+/**
+ * @}
+ */
+
+
+/**
+ * \class OneWirePIO	Streams PIO states to and from a DS2408 or DS2413.
+ *
+ * beginWrite() selects the switch and starts a PIO write; from then on, every write() sends one state byte and its
+ * inverse, and reads back the confirmation byte and the pin states, without any reset or ROM command in between.
+ * beginRead() likewise starts a PIO read, after which read() samples the pins continuously. DS2408 samples come in
+ * blocks of 32, each followed by a CRC16 which is checked as soon as it arrives; every DS2413 sample carries its own
+ * complement, which is checked instead.
+ *
+ * Each byte is read after a single status read has shown the bridge idle. DS2408 blocks are read with
+ * wireReadBytesCrc16(), which folds every sample into the CRC16 as it comes in; the other bytes are read with
+ * wireStreamBytes(), which computes no CRC at all. A failed check ends the stream; the switch then has to be selected
+ * again with beginWrite() or beginRead().
+ * \code{.cpp}
+ * OneWirePIO relays(oneWire);
+ * relays.beginWrite(rom);
+ * for (;;) {
+ *     if (!relays.write(pattern)) {
+ *         relays.beginWrite(rom);
+ *     }
+ *     ...
+ * }
+ * \endcode
+ */
+class OneWirePIO {
+public:
+	/**
+	 * \param[in]	bus	The bus the switch is on.
+	 */
+	OneWirePIO(OneWire &bus);
+
+	/**
+	 * Selects a switch, and starts a PIO write.
+	 *
+	 * \param[in]	rom	The ROM of the switch; its family code tells a DS2408 from a DS2413.
+	 *
+	 * \return	1 if the switch answered the reset, 0 otherwise.
+	 */
+	uint8_t beginWrite(const uint8_t rom[8]);
+
+	/**
+	 * Sets the output latches. On a DS2413, only bits 0 (PIOA) and 1 (PIOB) are used.
+	 *
+	 * \param[in]	state	The latch state; a 0 bit turns the output transistor on.
+	 * \param[out]	pins	If not NULL, receives the pin states the switch reports after the write: the PIO levels
+	 *						on a DS2408, and the PIO status nibble (pin and latch of PIOA and PIOB) on a DS2413.
+	 *
+	 * \return	1 if the switch confirmed the write, 0 if it did not (the stream has ended).
+	 */
+	uint8_t write(uint8_t state, uint8_t *pins = 0);
+
+	/**
+	 * Writes several latch states in a row, as write() does for each one.
+	 *
+	 * \param[in]	states	The latch states.
+	 * \param[in]	count	The number of states.
+	 * \param[out]	pins	If not NULL, receives the pin states reported after each write.
+	 *
+	 * \return	The number of states which were confirmed; fewer than count if the stream has ended.
+	 */
+	uint16_t write(const uint8_t *states, uint16_t count, uint8_t *pins = 0);
+
+	/**
+	 * Selects a switch, and starts a PIO read.
+	 *
+	 * \param[in]	rom	The ROM of the switch.
+	 *
+	 * \return	1 if the switch answered the reset, 0 otherwise.
+	 */
+	uint8_t beginRead(const uint8_t rom[8]);
+
+	/**
+	 * Samples the pins. DS2408 samples are the PIO levels; DS2413 samples are the PIO status nibble.
+	 *
+	 * \param[out]	samples	The buffer the samples are stored to.
+	 * \param[in]	count	The number of samples to take.
+	 *
+	 * \return	The number of samples which passed their check; fewer than count if the stream has ended.
+	 *
+	 * \note	A DS2408 sample can only be trusted once the CRC16 of its block has checked out; if count does not end on
+	 *			a block boundary, the rest of the last block is read and discarded. Reading multiples of
+	 *			ONEWIRE_PIO_BLOCK avoids that.
+	 */
+	uint16_t read(uint8_t *samples, uint16_t count);
+
+	/**
+	 * \return	1 while a write or read stream is running, 0 once it has ended (or none was started).
+	 */
+	uint8_t isStreaming();
+
+private:
+	uint8_t begin(const uint8_t rom[8], uint8_t command);
+
+	OneWire &mBus;
+	uint8_t mFamily;
+	uint8_t mCommand;
+
+	/* DS2408 read streams: the first block's CRC16 also covers the command byte */
+	uint8_t mFirstBlock;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREPIO_H__ */
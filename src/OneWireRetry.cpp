@@ -0,0 +1,198 @@
+/**
+ * \file OneWireRetry.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireRetry.h"
+
+
+OneWireRetry::OneWireRetry(OneWire &bus, OneWireDeviceHealth *health, uint8_t capacity) :
+		mBus(bus), mHealth(health), mCapacity(capacity) {
+	mCount = 0;
+}
+
+
+uint8_t OneWireRetry::transfer(const uint8_t rom[8], const uint8_t *command, uint8_t commandLen, uint8_t *response,
+		uint8_t responseLen) {
+	OneWireLock guard(mBus);
+	uint32_t now = millis();
+	uint8_t index = indexOf(rom);
+	uint8_t attempts = ONEWIRE_RETRY_ATTEMPTS;
+
+	if (index == 0xFF && mCount < mCapacity) {
+		index = mCount++;
+		for (uint8_t i = 0; i < 8; i++) {
+			mHealth[index].rom[i] = rom[i];
+		}
+		mHealth[index].failures = 0;
+		mHealth[index].lastResult = ONEWIRE_RETRY_OK;
+		mHealth[index].flags = 0;
+		mHealth[index].retryAt = now;
+	}
+
+	if (index != 0xFF) {
+		OneWireDeviceHealth &health = mHealth[index];
+
+		if (health.failures && (int32_t)(now - health.retryAt) < 0) {
+			return ONEWIRE_RETRY_DEFERRED;
+		}
+
+		/* A quarantined device only gets to prove it has recovered; it does not get the full set of retries */
+		if (health.flags & ONEWIRE_HEALTH_QUARANTINED) {
+			attempts = 1;
+		}
+	}
+
+	uint8_t result;
+	do {
+		result = attempt(rom, command, commandLen, response, responseLen);
+	} while (result != ONEWIRE_RETRY_OK && --attempts);
+
+	if (index != 0xFF) {
+		OneWireDeviceHealth &health = mHealth[index];
+
+		health.lastResult = result;
+		if (result == ONEWIRE_RETRY_OK) {
+			health.failures = 0;
+			health.flags &= ~ONEWIRE_HEALTH_QUARANTINED;
+		} else if (result != ONEWIRE_RETRY_BUS) {
+			recordFailure(health, millis());
+		}
+	}
+
+	return result;
+}
+
+
+uint8_t OneWireRetry::isDeferred(const uint8_t rom[8]) {
+	uint8_t index = indexOf(rom);
+
+	if (index == 0xFF || !mHealth[index].failures) {
+		return 0;
+	}
+
+	return (int32_t)(millis() - mHealth[index].retryAt) < 0;
+}
+
+
+void OneWireRetry::release(const uint8_t rom[8]) {
+	uint8_t index = indexOf(rom);
+
+	if (index != 0xFF) {
+		mHealth[index].failures = 0;
+		mHealth[index].flags &= ~ONEWIRE_HEALTH_QUARANTINED;
+	}
+}
+
+
+void OneWireRetry::clear() {
+	mCount = 0;
+}
+
+
+uint8_t OneWireRetry::getCount() {
+	return mCount;
+}
+
+
+OneWireDeviceHealth &OneWireRetry::getHealth(uint8_t index) {
+	return mHealth[index];
+}
+
+
+uint8_t OneWireRetry::indexOf(const uint8_t rom[8]) {
+	for (uint8_t d = 0; d < mCount; d++) {
+		uint8_t i = 0;
+		while (i < 8 && mHealth[d].rom[i] == rom[i]) {
+			i++;
+		}
+		if (i == 8) {
+			return d;
+		}
+	}
+
+	return 0xFF;
+}
+
+
+/**
+ * Runs the transaction once. The bridge's error flags are cleared first, so that a timeout flagged by any primitive
+ * of this attempt is noticed; after a timeout, the bridge is reset, since it cannot be trusted to be idle.
+ */
+uint8_t OneWireRetry::attempt(const uint8_t rom[8], const uint8_t *command, uint8_t commandLen, uint8_t *response,
+		uint8_t responseLen) {
+	uint8_t result = ONEWIRE_RETRY_OK;
+
+	mBus.clearError();
+
+	if (!mBus.wireReset()) {
+		result = (mBus.getError() & DS2482_ERROR_SHORT) ? ONEWIRE_RETRY_BUS : ONEWIRE_RETRY_NO_PRESENCE;
+	} else {
+		mBus.wireSelect(rom);
+		mBus.wireWriteBytes(command, commandLen);
+
+		if (responseLen && mBus.wireReadBytes(response, responseLen)) {
+			mBus.noteCrcError();
+			result = ONEWIRE_RETRY_CRC;
+		} else if (responseLen && isBlank(response, responseLen)) {
+			/* A line held low reads as zeros, and a run of zeros ends in a matching CRC8 of 0 */
+			result = ONEWIRE_RETRY_CRC;
+		}
+	}
+
+	if (mBus.getError() & DS2482_ERROR_TIMEOUT) {
+		/* A device reset returns a DS2482-800 to channel 0, so the channel the transaction was on is restored */
+		uint8_t channel = mBus.getChannel();
+
+		mBus.deviceReset();
+		if (channel != DS2482_CHANNEL_UNKNOWN) {
+			mBus.selectChannel(channel);
+		}
+		result = ONEWIRE_RETRY_BUS;
+	}
+
+	return result;
+}
+
+
+uint8_t OneWireRetry::isBlank(const uint8_t *response, uint8_t responseLen) {
+	uint8_t bits = 0;
+
+	for (uint8_t i = 0; i < responseLen; i++) {
+		bits |= response[i];
+	}
+
+	return bits ? false : true;
+}
+
+
+/**
+ * Backs the device off for ONEWIRE_RETRY_BACKOFF milliseconds, doubled for each further consecutive failure, or
+ * quarantines it once it has failed ONEWIRE_RETRY_QUARANTINE times in a row.
+ */
+void OneWireRetry::recordFailure(OneWireDeviceHealth &health, uint32_t now) {
+	if (health.failures < 0xFF) {
+		health.failures++;
+	}
+
+	if (health.failures >= ONEWIRE_RETRY_QUARANTINE) {
+		health.flags |= ONEWIRE_HEALTH_QUARANTINED;
+		health.retryAt = now + ONEWIRE_RETRY_PROBE;
+		return;
+	}
+
+	uint32_t backoff = ONEWIRE_RETRY_BACKOFF;
+	for (uint8_t i = 1; i < health.failures && backoff < ONEWIRE_RETRY_BACKOFF_MAX; i++) {
+		backoff <<= 1;
+	}
+	if (backoff > ONEWIRE_RETRY_BACKOFF_MAX) {
+		backoff = ONEWIRE_RETRY_BACKOFF_MAX;
+	}
+
+	health.retryAt = now + backoff;
+}
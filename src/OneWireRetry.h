@@ -0,0 +1,182 @@
+/**
+ * \file OneWireRetry.h
+ * Provides a retry layer for addressed 1-Wire transactions, which backs off devices that keep failing so that they do
+ * not eat into the bus time of the healthy ones.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIRERETRY_H__
+#define _DS2482OW__SRC_ONEWIRERETRY_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+
+
+/**
+ * \defgroup retryDefinitions	Retry policy defaults and transaction results.
+ * @{
+ */
+
+/**
+ * \def ONEWIRE_RETRY_ATTEMPTS	How many times a transaction is attempted before it counts as a failure of the device.
+ */
+#ifndef ONEWIRE_RETRY_ATTEMPTS
+#define ONEWIRE_RETRY_ATTEMPTS			3
+#endif
+
+/**
+ * \def ONEWIRE_RETRY_BACKOFF	The time, in milliseconds, a device is skipped after its first failure; it doubles for
+ *								every further consecutive failure.
+ */
+#ifndef ONEWIRE_RETRY_BACKOFF
+#define ONEWIRE_RETRY_BACKOFF			250
+#endif
+
+/**
+ * \def ONEWIRE_RETRY_BACKOFF_MAX	The longest time, in milliseconds, a device which is not quarantined is skipped.
+ */
+#ifndef ONEWIRE_RETRY_BACKOFF_MAX
+#define ONEWIRE_RETRY_BACKOFF_MAX		8000
+#endif
+
+/**
+ * \def ONEWIRE_RETRY_QUARANTINE	The number of consecutive failures after which a device is quarantined.
+ */
+#ifndef ONEWIRE_RETRY_QUARANTINE
+#define ONEWIRE_RETRY_QUARANTINE		6
+#endif
+
+/**
+ * \def ONEWIRE_RETRY_PROBE	How often, in milliseconds, a quarantined device is given a single attempt to recover.
+ */
+#ifndef ONEWIRE_RETRY_PROBE
+#define ONEWIRE_RETRY_PROBE				60000
+#endif
+
+#define ONEWIRE_RETRY_OK				0	/*! The transaction succeeded */
+#define ONEWIRE_RETRY_NO_PRESENCE		1	/*! No device answered the reset */
+#define ONEWIRE_RETRY_CRC				2	/*! The response did not pass its CRC8, or read as all zeros */
+#define ONEWIRE_RETRY_BUS				3	/*! The bridge timed out, or the bus is shorted; not held against the device */
+#define ONEWIRE_RETRY_DEFERRED			4	/*! The device is backing off or quarantined; nothing was sent */
+
+#define ONEWIRE_HEALTH_QUARANTINED		(1<<0)	/*! The device failed too often, and is only probed occasionally */
+/**
+ * @}
+ */
+
+
+/**
+ * \struct OneWireDeviceHealth	The retry layer's record of one device. An array of these is provided by the caller.
+ */
+struct OneWireDeviceHealth {
+	uint8_t rom[8];			/*!< The ROM of the device */
+	uint8_t failures;		/*!< Consecutive failed transactions; reset by a successful one */
+	uint8_t lastResult;		/*!< The ONEWIRE_RETRY_ result of the last transaction that was attempted */
+	uint8_t flags;			/*!< A combination of the ONEWIRE_HEALTH_ flags */
+	uint32_t retryAt;		/*!< The millis() time before which the device is skipped */
+};
+
+
+/**
+ * \class OneWireRetry	Runs addressed transactions, retrying transient failures.
+ *
+ * Each transaction is a reset, a Match ROM, a command and an optional response, which is checked against the CRC8 it
+ * ends with; a response of only zeros passes that check, but is what a line held low reads as, and is rejected too. A
+ * transaction which fails (no presence, bad CRC, bridge timeout) is attempted again right away, up to
+ * ONEWIRE_RETRY_ATTEMPTS times. If every attempt fails, the device backs off: its transactions return
+ * ONEWIRE_RETRY_DEFERRED without touching the bus, for a time that doubles with each consecutive failure. After
+ * ONEWIRE_RETRY_QUARANTINE consecutive failures, the device is quarantined, and only gets a single attempt every
+ * ONEWIRE_RETRY_PROBE milliseconds until it succeeds again (or is released).
+ *
+ * A timeout or a short is a fault of the bus, not of the device being addressed; the bridge is reset before the next
+ * attempt, but the device is not made to back off for it.
+ * \code{.cpp}
+ * OneWireDeviceHealth health[8];
+ * OneWireRetry retry(oneWire, health, 8);
+ * ...
+ * uint8_t command = 0xBE;
+ * uint8_t scratchpad[9];
+ * if (retry.transfer(rom, &command, 1, scratchpad, 9) == ONEWIRE_RETRY_OK) {
+ *     ...
+ * }
+ * \endcode
+ */
+class OneWireRetry {
+public:
+	/**
+	 * \param[in]	bus			The bus the devices are on.
+	 * \param[in]	health		Caller-provided storage for the device records.
+	 * \param[in]	capacity	The number of records the storage has room for.
+	 */
+	OneWireRetry(OneWire &bus, OneWireDeviceHealth *health, uint8_t capacity);
+
+	/**
+	 * Runs a transaction with a device. Devices are tracked from their first transaction on; once the storage is full,
+	 * further devices still get their retries, but never back off.
+	 *
+	 * \param[in]	rom				The ROM of the device.
+	 * \param[in]	command			The bytes to send after Match ROM.
+	 * \param[in]	commandLen		The number of bytes to send.
+	 * \param[out]	response		The buffer the response is read into; may be NULL if responseLen is 0.
+	 * \param[in]	responseLen		The number of bytes to read, including the CRC8 the response must end with; 0 if
+	 *								the command has no response.
+	 *
+	 * \return	One of the ONEWIRE_RETRY_ results.
+	 */
+	uint8_t transfer(const uint8_t rom[8], const uint8_t *command, uint8_t commandLen, uint8_t *response,
+			uint8_t responseLen);
+
+	/**
+	 * \param[in]	rom	The ROM of a device.
+	 *
+	 * \return	1 if transactions with the device are currently deferred, 0 if they would be attempted.
+	 */
+	uint8_t isDeferred(const uint8_t rom[8]);
+
+	/**
+	 * Ends the backoff or quarantine of a device, for instance after it has been replaced.
+	 *
+	 * \param[in]	rom	The ROM of the device.
+	 */
+	void release(const uint8_t rom[8]);
+
+	/**
+	 * Forgets every device.
+	 */
+	void clear();
+
+	/**
+	 * \return	The number of devices being tracked.
+	 */
+	uint8_t getCount();
+
+	/**
+	 * \param[in]	index	The index of the device.
+	 *
+	 * \return	The record of the device.
+	 */
+	OneWireDeviceHealth &getHealth(uint8_t index);
+
+	/**
+	 * \param[in]	rom	A ROM to look for.
+	 *
+	 * \return	The index of the device with that ROM, or 0xFF if it is not being tracked.
+	 */
+	uint8_t indexOf(const uint8_t rom[8]);
+
+private:
+	uint8_t attempt(const uint8_t rom[8], const uint8_t *command, uint8_t commandLen, uint8_t *response,
+			uint8_t responseLen);
+	static uint8_t isBlank(const uint8_t *response, uint8_t responseLen);
+	void recordFailure(OneWireDeviceHealth &health, uint32_t now);
+
+	OneWire &mBus;
+	OneWireDeviceHealth *mHealth;
+	uint8_t mCapacity;
+	uint8_t mCount;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIRERETRY_H__ */
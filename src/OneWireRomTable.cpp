@@ -0,0 +1,125 @@
+/**
+ * \file OneWireRomTable.cpp
+ *
+ * Portions Copyright (C) 2017 Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * See README.md for additional author/copyright info.
+ */
+
+/* ---------------------------------------------------------------------------- */
+/* INCLUDES                                                                     */
+/* ---------------------------------------------------------------------------- */
+#include "OneWireRomTable.h"
+#include <string.h>
+
+
+OneWireRomTable::OneWireRomTable(uint8_t (*roms)[8], uint8_t capacity) : mRoms(roms), mCapacity(capacity) {
+	mCount = 0;
+}
+
+
+uint8_t OneWireRomTable::add(const uint8_t rom[8]) {
+	uint8_t index = lowerBound(rom, 8);
+
+	if (index < mCount && memcmp(mRoms[index], rom, 8) == 0) {
+		return index;
+	}
+	if (mCount >= mCapacity) {
+		return 0xFF;
+	}
+
+	memmove(mRoms[index + 1], mRoms[index], (mCount - index) * 8);
+	memcpy(mRoms[index], rom, 8);
+	mCount++;
+
+	return index;
+}
+
+
+uint8_t OneWireRomTable::remove(const uint8_t rom[8]) {
+	uint8_t index = indexOf(rom);
+
+	if (index == 0xFF) {
+		return false;
+	}
+
+	mCount--;
+	memmove(mRoms[index], mRoms[index + 1], (mCount - index) * 8);
+
+	return true;
+}
+
+
+uint8_t OneWireRomTable::load(OneWireInventory &inventory, uint8_t presentOnly) {
+	mCount = 0;
+
+	for (uint8_t d = 0; d < inventory.getCount(); d++) {
+		OneWireInventoryEntry &entry = inventory.getEntry(d);
+
+		if (presentOnly && !(entry.flags & ONEWIRE_DEVICE_PRESENT)) {
+			continue;
+		}
+		add(entry.rom);
+	}
+
+	return mCount;
+}
+
+
+uint8_t OneWireRomTable::indexOf(const uint8_t rom[8]) {
+	uint8_t index = lowerBound(rom, 8);
+
+	return (index < mCount && memcmp(mRoms[index], rom, 8) == 0) ? index : 0xFF;
+}
+
+
+uint8_t OneWireRomTable::findFamily(uint8_t family, uint8_t *first) {
+	uint8_t start = lowerBound(&family, 1);
+	uint8_t end = start;
+
+	/* The family is usually only a handful of devices, so its end is found by stepping rather than a second search */
+	while (end < mCount && mRoms[end][0] == family) {
+		end++;
+	}
+
+	if (first) {
+		*first = start;
+	}
+
+	return end - start;
+}
+
+
+void OneWireRomTable::clear() {
+	mCount = 0;
+}
+
+
+uint8_t OneWireRomTable::getCount() {
+	return mCount;
+}
+
+
+const uint8_t *OneWireRomTable::getRom(uint8_t index) {
+	return mRoms[index];
+}
+
+
+/**
+ * Returns the index of the first ROM whose leading bytes are not less than the key, or the count if there is none.
+ */
+uint8_t OneWireRomTable::lowerBound(const uint8_t *key, uint8_t length) {
+	uint8_t low = 0;
+	uint8_t high = mCount;
+
+	while (low < high) {
+		uint8_t middle = low + ((high - low) >> 1);
+
+		if (memcmp(mRoms[middle], key, length) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
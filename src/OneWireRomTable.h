@@ -0,0 +1,117 @@
+/**
+ * \file OneWireRomTable.h
+ * Provides a compact, sorted table of device ROMs, in which a device, or all the devices of a family, are found with a
+ * binary search instead of a scan.
+ *
+ * \date		2017
+ * \author		Gerad Munsch <gmunsch@unforgivendevelopment.com>
+ * \copyright	See README.md for more information about authors and copyrights.
+ */
+
+#ifndef _DS2482OW__SRC_ONEWIREROMTABLE_H__
+#define _DS2482OW__SRC_ONEWIREROMTABLE_H__
+
+#include <inttypes.h>
+#include "OneWire.h"
+#include "OneWireInventory.h"
+
+
+/**
+ * \class OneWireRomTable	Keeps a set of ROMs sorted by their bytes, family code first.
+ *
+ * The table takes nothing but the 8 bytes of each ROM, in caller-provided storage (the same layout searchAll() fills
+ * in). Since the family code is the first byte, the devices of a family sit next to each other, and findFamily()
+ * returns them as a range, without scanning the table. indexOf() takes at most 6 comparisons for a table of 50
+ * devices, where OneWireInventory::indexOf() takes up to 50.
+ *
+ * The table is meant to be built once the bus is known, and only changed when the inventory changes:
+ * \code{.cpp}
+ * static uint8_t roms[16][8];
+ * OneWireRomTable table(roms, 16);
+ * ...
+ * inventory.refresh();
+ * table.load(inventory, 1);
+ * uint8_t first;
+ * uint8_t sensors = table.findFamily(0x28, &first);
+ * \endcode
+ */
+class OneWireRomTable {
+public:
+	/**
+	 * \param[in]	roms		Caller-provided storage for the table.
+	 * \param[in]	capacity	The number of ROMs the storage has room for.
+	 */
+	OneWireRomTable(uint8_t (*roms)[8], uint8_t capacity);
+
+	/**
+	 * Adds a ROM to the table, at its place in the sort order.
+	 *
+	 * \param[in]	rom	The ROM to add.
+	 *
+	 * \return	The index of the ROM (which it already had if it was in the table), or 0xFF if the table is full.
+	 */
+	uint8_t add(const uint8_t rom[8]);
+
+	/**
+	 * Removes a ROM from the table.
+	 *
+	 * \param[in]	rom	The ROM to remove.
+	 *
+	 * \return	1 if it was removed, 0 if it was not in the table.
+	 */
+	uint8_t remove(const uint8_t rom[8]);
+
+	/**
+	 * Replaces the contents of the table with the devices of an inventory. Devices beyond the table's capacity are
+	 * left out.
+	 *
+	 * \param[in]	inventory	The inventory to load.
+	 * \param[in]	presentOnly	1 to only load the devices which are flagged present, 0 to load all of them.
+	 *
+	 * \return	The number of ROMs in the table.
+	 */
+	uint8_t load(OneWireInventory &inventory, uint8_t presentOnly = 0);
+
+	/**
+	 * \param[in]	rom	A ROM to look for.
+	 *
+	 * \return	The index of the ROM, or 0xFF if it is not in the table.
+	 */
+	uint8_t indexOf(const uint8_t rom[8]);
+
+	/**
+	 * Finds the devices of a family.
+	 *
+	 * \param[in]	family	The family code to look for.
+	 * \param[out]	first	If not NULL, receives the index of the first device of the family.
+	 *
+	 * \return	The number of devices of the family; they are at the indices from first on.
+	 */
+	uint8_t findFamily(uint8_t family, uint8_t *first = 0);
+
+	/**
+	 * Removes all ROMs from the table.
+	 */
+	void clear();
+
+	/**
+	 * \return	The number of ROMs in the table.
+	 */
+	uint8_t getCount();
+
+	/**
+	 * \param[in]	index	The index of the ROM.
+	 *
+	 * \return	The ROM.
+	 */
+	const uint8_t *getRom(uint8_t index);
+
+private:
+	uint8_t lowerBound(const uint8_t *key, uint8_t length);
+
+	uint8_t (*mRoms)[8];
+	uint8_t mCapacity;
+	uint8_t mCount;
+};
+
+#endif	/* _DS2482OW__SRC_ONEWIREROMTABLE_H__ */